@@ -0,0 +1,461 @@
+// Microbenchmarks of stack_vector against std::vector and std::array.
+//
+// Every operation is run for each element type, size and container, and the results are written
+// as JSON (to stdout, or to the file given with --out) so runs can be diffed between releases.
+//
+// Usage: bench [--out file.json] [--filter text] [--max-size n] [--min-time seconds] [--samples n]
+//   --filter    only run benchmarks whose name (operation/type/container/size) contains text
+//   --max-size  skip sizes above n
+//   --min-time  minimum duration of one sample, 0.01 seconds by default
+//   --samples   samples taken per benchmark, 5 by default; the median is reported
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <stack_vector.hpp>
+#include <small_vector.hpp>
+
+// Trivially copyable float3, like the one of Test1/Test2 without the logging.
+struct float3
+{
+	float x = 0.0f, y = 0.0f, z = 0.0f;
+	float3() {}
+	float3(float scalar) : x(scalar), y(scalar), z(scalar) {}
+	float3(float x, float y, float z) : x(x), y(y), z(z) {}
+};
+
+inline bool operator==(const float3& lhs, const float3& rhs) { return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z; }
+inline bool operator<(const float3& lhs, const float3& rhs)
+{
+	if (lhs.x != rhs.x) return lhs.x < rhs.x;
+	if (lhs.y != rhs.y) return lhs.y < rhs.y;
+	return lhs.z < rhs.z;
+}
+
+/*----------------------------------------------------------*/
+/*						   Harness							*/
+/*----------------------------------------------------------*/
+
+namespace {
+
+	struct options
+	{
+		const char* out = nullptr;
+		std::string filter;
+		size_t max_size = static_cast<size_t>(-1);
+		double min_time = 0.01;
+		size_t samples = 5;
+	};
+
+	struct result
+	{
+		std::string name, operation, type, container;
+		size_t size;
+		size_t iterations;
+		double median_ns, min_ns, max_ns; // Per iteration.
+	};
+
+	options g_options;
+	std::vector<result> g_results;
+
+	// Keep the compiler from optimising away a value nothing reads.
+	template<typename T>
+	inline void do_not_optimize(const T& value)
+	{
+	#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+	#else
+		static volatile const void* sink;
+		sink = &value;
+	#endif
+	}
+
+	template<typename Body>
+	inline double time_body(Body& body, size_t iterations)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		body(iterations);
+		const auto stop = std::chrono::steady_clock::now();
+		return std::chrono::duration<double>(stop - start).count();
+	}
+
+	// Time body(iterations), with iterations raised until one sample takes at least min_time.
+	template<typename Body>
+	void run(const char* operation, const char* type, const char* container, size_t size, Body body)
+	{
+		const std::string name = std::string(operation) + "/" + type + "/" + container + "/" + std::to_string(size);
+		if (!g_options.filter.empty() && name.find(g_options.filter) == std::string::npos)
+			return;
+
+		std::fprintf(stderr, "%s\n", name.c_str());
+
+		size_t iterations = 1;
+		for (;;) {
+			const double elapsed = time_body(body, iterations);
+			if (elapsed >= g_options.min_time || iterations >= (size_t(1) << 32))
+				break;
+
+			const double scale = elapsed > 0.0 ? g_options.min_time * 1.2 / elapsed : 100.0;
+			iterations = static_cast<size_t>(iterations * std::min(100.0, std::max(2.0, scale)));
+		}
+
+		std::vector<double> samples;
+		for (size_t i = 0; i < g_options.samples; ++i)
+			samples.push_back(time_body(body, iterations) * 1e9 / iterations);
+		std::sort(samples.begin(), samples.end());
+
+		result r;
+		r.name = name;
+		r.operation = operation;
+		r.type = type;
+		r.container = container;
+		r.size = size;
+		r.iterations = iterations;
+		r.median_ns = samples[samples.size() / 2];
+		r.min_ns = samples.front();
+		r.max_ns = samples.back();
+		g_results.push_back(r);
+	}
+
+	void write_json(std::FILE* file)
+	{
+		std::fprintf(file, "{\n  \"context\": {\n");
+	#if defined(__clang__)
+		std::fprintf(file, "    \"compiler\": \"clang %s\",\n", __clang_version__);
+	#elif defined(__GNUC__)
+		std::fprintf(file, "    \"compiler\": \"gcc %s\",\n", __VERSION__);
+	#elif defined(_MSC_VER)
+		std::fprintf(file, "    \"compiler\": \"msvc %d\",\n", _MSC_VER);
+	#else
+		std::fprintf(file, "    \"compiler\": \"unknown\",\n");
+	#endif
+		std::fprintf(file, "    \"cplusplus\": %ld,\n", static_cast<long>(__cplusplus));
+	#if defined(__OPTIMIZE__) || (defined(_MSC_VER) && !defined(_DEBUG))
+		std::fprintf(file, "    \"optimized\": true,\n");
+	#else
+		std::fprintf(file, "    \"optimized\": false,\n");
+	#endif
+		std::fprintf(file, "    \"min_time\": %g,\n    \"samples\": %zu\n  },\n", g_options.min_time, g_options.samples);
+
+		std::fprintf(file, "  \"benchmarks\": [\n");
+		for (size_t i = 0; i < g_results.size(); ++i) {
+			const result& r = g_results[i];
+			std::fprintf(file,
+				"    {\"name\": \"%s\", \"operation\": \"%s\", \"type\": \"%s\", \"container\": \"%s\", \"size\": %zu, "
+				"\"iterations\": %zu, \"median_ns\": %.3f, \"min_ns\": %.3f, \"max_ns\": %.3f, \"ns_per_element\": %.4f}%s\n",
+				r.name.c_str(), r.operation.c_str(), r.type.c_str(), r.container.c_str(), r.size,
+				r.iterations, r.median_ns, r.min_ns, r.max_ns, r.median_ns / static_cast<double>(r.size),
+				i + 1 < g_results.size() ? "," : "");
+		}
+		std::fprintf(file, "  ]\n}\n");
+	}
+
+	/*----------------------------------------------------------*/
+	/*						 Element types						*/
+	/*----------------------------------------------------------*/
+
+	// Deterministic element values, so every run sees the same data.
+	inline void make_value(int& value, size_t i) { value = static_cast<int>((i * 2654435761u) & 0x7FFFFFFF); }
+	inline void make_value(float3& value, size_t i) { value = float3(float(i), float(i) + 1.0f, float(i) + 2.0f); }
+	inline void make_value(std::string& value, size_t i) { value = "item " + std::to_string(i % 100000); } // Fits the small string buffer.
+
+	template<typename T>
+	std::vector<T> make_values(size_t n)
+	{
+		std::vector<T> values(n);
+		for (size_t i = 0; i < n; ++i)
+			make_value(values[i], i);
+		return values;
+	}
+
+	template<typename C> inline void emplace_from(C& c, int value) { c.emplace_back(value); }
+	template<typename C> inline void emplace_from(C& c, const float3& value) { c.emplace_back(value.x, value.y, value.z); }
+	template<typename C> inline void emplace_from(C& c, const std::string& value) { c.emplace_back(value.data(), value.size()); }
+
+	// What iteration adds up.
+	inline long long key(int value) { return value; }
+	inline float key(const float3& value) { return value.x + value.y + value.z; }
+	inline size_t key(const std::string& value) { return value.size(); }
+
+	/*----------------------------------------------------------*/
+	/*						  Containers						*/
+	/*----------------------------------------------------------*/
+
+	// Above this many elements the inline containers would need megabytes of stack.
+	constexpr size_t inline_limit = 4096;
+
+	struct std_vector_kind
+	{
+		template<typename T, size_t Size> using type = std::vector<T>;
+		static const char* name() { return "std::vector"; }
+		static constexpr bool fits(size_t) { return true; }
+		template<typename C> static void prepare(C&, size_t) {}
+	};
+
+	struct reserved_vector_kind
+	{
+		template<typename T, size_t Size> using type = std::vector<T>;
+		static const char* name() { return "std::vector+reserve"; }
+		static constexpr bool fits(size_t) { return true; }
+		template<typename C> static void prepare(C& c, size_t n) { c.reserve(n); }
+	};
+
+	// Inline only, with room for the insert benchmarks to go one past Size.
+	struct stack_vector_kind
+	{
+		template<typename T, size_t Size> using type = sad::stack_vector<T, Size + 1>;
+		static const char* name() { return "stack_vector"; }
+		static constexpr bool fits(size_t size) { return size <= inline_limit; }
+		template<typename C> static void prepare(C&, size_t) {}
+	};
+
+	// 64 elements inline, then the heap.
+	struct small_vector_kind
+	{
+		template<typename T, size_t Size> using type = sad::small_vector<T, 64>;
+		static const char* name() { return "small_vector<64>"; }
+		static constexpr bool fits(size_t) { return true; }
+		template<typename C> static void prepare(C&, size_t) {}
+	};
+
+	template<typename Kind, typename C, typename T>
+	inline void fill(C& c, const std::vector<T>& values)
+	{
+		Kind::prepare(c, values.size());
+		for (const T& value : values)
+			c.push_back(value);
+	}
+
+	/*----------------------------------------------------------*/
+	/*						  Operations						*/
+	/*----------------------------------------------------------*/
+
+	enum class position { front, middle, back };
+
+	template<typename Kind, typename T, size_t Size>
+	void bench_insert_erase(const char* operation, const char* type, const std::vector<T>& values, position where)
+	{
+		using C = typename Kind::template type<T, Size>;
+
+		C c;
+		fill<Kind>(c, values);
+		const size_t index = where == position::front ? 0 : (where == position::middle ? Size / 2 : Size);
+		const T value = values[Size / 3];
+
+		// One insert and one erase per iteration, so the size stays put.
+		run(operation, type, Kind::name(), Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				c.insert(c.begin() + index, value);
+				c.erase(c.begin() + index);
+			}
+			do_not_optimize(c.data());
+		});
+	}
+
+	template<typename Kind, typename T, size_t Size>
+	void bench_kind(const char* type, const std::vector<T>& values, std::true_type)
+	{
+		using C = typename Kind::template type<T, Size>;
+		const char* container = Kind::name();
+
+		run("push_back", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				C c;
+				fill<Kind>(c, values);
+				do_not_optimize(c.data());
+			}
+		});
+
+		run("emplace_back", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				C c;
+				Kind::prepare(c, Size);
+				for (const T& value : values)
+					emplace_from(c, value);
+				do_not_optimize(c.data());
+			}
+		});
+
+		bench_insert_erase<Kind, T, Size>("insert_erase_front", type, values, position::front);
+		bench_insert_erase<Kind, T, Size>("insert_erase_middle", type, values, position::middle);
+		bench_insert_erase<Kind, T, Size>("insert_erase_back", type, values, position::back);
+
+		C a;
+		fill<Kind>(a, values);
+		C b(a);
+
+		run("iterate", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				decltype(key(values[0])) sum = 0;
+				for (const T& value : a)
+					sum += key(value);
+				do_not_optimize(sum);
+			}
+		});
+
+		run("copy", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				C copy(a);
+				do_not_optimize(copy.data());
+			}
+		});
+
+		// Moved there and back again, so a still holds everything afterwards.
+		run("move", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				C moved(std::move(a));
+				a = std::move(moved);
+				do_not_optimize(a.data());
+			}
+		});
+
+		// Equal vectors, the worst case of both.
+		run("equal", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				const bool same = a == b;
+				do_not_optimize(same);
+			}
+		});
+
+		run("less", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				const bool less = a < b;
+				do_not_optimize(less);
+			}
+		});
+	}
+
+	template<typename Kind, typename T, size_t Size>
+	void bench_kind(const char*, const std::vector<T>&, std::false_type) {}
+
+	// std::array has no push_back, its "push_back" writes each element in turn.
+	template<typename T, size_t Size>
+	void bench_array(const char* type, const std::vector<T>& values, std::true_type)
+	{
+		using C = std::array<T, Size>;
+		const char* container = "std::array";
+
+		run("push_back", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				C c;
+				for (size_t j = 0; j < Size; ++j)
+					c[j] = values[j];
+				do_not_optimize(c.data());
+			}
+		});
+
+		C a;
+		std::copy(values.begin(), values.end(), a.begin());
+		C b(a);
+
+		run("iterate", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				decltype(key(values[0])) sum = 0;
+				for (const T& value : a)
+					sum += key(value);
+				do_not_optimize(sum);
+			}
+		});
+
+		run("copy", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				C copy(a);
+				do_not_optimize(copy.data());
+			}
+		});
+
+		run("move", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				C moved(std::move(a));
+				a = std::move(moved);
+				do_not_optimize(a.data());
+			}
+		});
+
+		run("equal", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				const bool same = a == b;
+				do_not_optimize(same);
+			}
+		});
+
+		run("less", type, container, Size, [&](size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				const bool less = a < b;
+				do_not_optimize(less);
+			}
+		});
+	}
+
+	template<typename T, size_t Size>
+	void bench_array(const char*, const std::vector<T>&, std::false_type) {}
+
+	template<typename T, size_t Size>
+	void bench_size(const char* type)
+	{
+		if (Size > g_options.max_size)
+			return;
+
+		const std::vector<T> values = make_values<T>(Size);
+		bench_kind<std_vector_kind, T, Size>(type, values, std::true_type());
+		bench_kind<reserved_vector_kind, T, Size>(type, values, std::true_type());
+		bench_array<T, Size>(type, values, std::integral_constant<bool, (Size <= inline_limit)>());
+		bench_kind<stack_vector_kind, T, Size>(type, values, std::integral_constant<bool, stack_vector_kind::fits(Size)>());
+		bench_kind<small_vector_kind, T, Size>(type, values, std::true_type());
+	}
+
+	template<typename T>
+	void bench_type(const char* type)
+	{
+		bench_size<T, 8>(type);
+		bench_size<T, 64>(type);
+		bench_size<T, 512>(type);
+		bench_size<T, 4096>(type);
+		bench_size<T, 32768>(type);
+		bench_size<T, 262144>(type);
+		bench_size<T, 1048576>(type);
+	}
+
+} // !namespace
+
+int main(int argc, char** argv)
+{
+	for (int i = 1; i < argc; ++i) {
+		const bool has_value = i + 1 < argc;
+		if (std::strcmp(argv[i], "--out") == 0 && has_value)
+			g_options.out = argv[++i];
+		else if (std::strcmp(argv[i], "--filter") == 0 && has_value)
+			g_options.filter = argv[++i];
+		else if (std::strcmp(argv[i], "--max-size") == 0 && has_value)
+			g_options.max_size = std::strtoull(argv[++i], nullptr, 10);
+		else if (std::strcmp(argv[i], "--min-time") == 0 && has_value)
+			g_options.min_time = std::strtod(argv[++i], nullptr);
+		else if (std::strcmp(argv[i], "--samples") == 0 && has_value)
+			g_options.samples = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+		else {
+			std::fprintf(stderr, "usage: %s [--out file.json] [--filter text] [--max-size n] [--min-time seconds] [--samples n]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	bench_type<int>("int");
+	bench_type<float3>("float3");
+	bench_type<std::string>("string");
+
+	std::FILE* file = g_options.out ? std::fopen(g_options.out, "w") : stdout;
+	if (!file) {
+		std::fprintf(stderr, "can't open %s\n", g_options.out);
+		return 1;
+	}
+
+	write_json(file);
+	if (file != stdout)
+		std::fclose(file);
+	return 0;
+}
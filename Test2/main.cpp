@@ -38,8 +38,8 @@ struct float3
 	}
 };
 
-template<typename T>
-void print(const sad::stack_vector<T>& vec) {
+template<typename T, size_t N>
+void print(const sad::stack_vector<T, N>& vec) {
 	std::cout << "Size: " << vec.size() << "\n";
 	std::cout << "Capacity: " << vec.capacity() << "\n";
 
@@ -50,7 +50,8 @@ void print(const sad::stack_vector<T>& vec) {
 	std::cout << "------------------------------" << std::endl;
 }
 
-void print(const sad::stack_vector<float3>& vec) {
+template<size_t N>
+void print(const sad::stack_vector<float3, N>& vec) {
 	std::cout << "Size: " << vec.size() << "\n";
 	std::cout << "Capacity: " << vec.capacity() << "\n";
 
@@ -62,7 +63,7 @@ void print(const sad::stack_vector<float3>& vec) {
 
 int main() {
 
-	sad::stack_vector<float3> foo;
+	sad::stack_vector<float3, 8> foo;
 	foo.assign(3, float3(100));
 	print(foo);
 	
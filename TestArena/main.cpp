@@ -0,0 +1,157 @@
+#include <cstdint>
+#include <cstdio>
+#include <new>
+
+#include <stack_arena.hpp>
+#include <stack_budget.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+// Check if ptr lies in the calling thread's stack, true when the bounds are unknown.
+static bool in_stack(const void* ptr)
+{
+	const sad::stack_bounds& bounds = sad::current_stack_bounds();
+	const char* p = static_cast<const char*>(ptr);
+	return bounds.low == nullptr || (p >= bounds.low && p < bounds.high);
+}
+
+// SAD_STACK_ARENA takes its block from the stack while it fits in the budget, from the heap once
+// it doesn't.
+static void budget()
+{
+	const size_t remaining = sad::stack_remaining();
+	CHECK(remaining > 0);
+	CHECK(sad::stack_can_fit(1024) && !sad::stack_can_fit(remaining));
+
+	int evaluated = 0;
+	SAD_STACK_ARENA(small, (evaluated++, 4096));
+	CHECK(evaluated == 1);
+	CHECK(small.on_stack() && small.capacity() == 4096);
+	void* block = small.allocate(1000);
+	CHECK(block != nullptr && in_stack(block));
+
+	SAD_STACK_ARENA(huge, remaining + 4096);
+	CHECK(!huge.on_stack() && huge.capacity() == remaining + 4096);
+	CHECK(!in_stack(huge.allocate(1000)));
+
+	// With the whole stack reserved as margin, even a small block goes to the heap.
+	const size_t margin = sad::stack_safety_margin();
+	sad::set_stack_safety_margin(remaining);
+	CHECK(!sad::stack_can_fit(64));
+	SAD_STACK_ARENA(squeezed, 64);
+	CHECK(!squeezed.on_stack() && !in_stack(squeezed.allocate(64)));
+	sad::set_stack_safety_margin(margin);
+	CHECK(sad::stack_safety_margin() == margin);
+}
+
+static bool aligned(const void* ptr, size_t alignment)
+{
+	return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+// Bump allocation, alignment, exhaustion, markers and growing in place.
+static void allocation()
+{
+	sad::fixed_stack_arena<1024> arena;
+	CHECK(arena.on_stack() && arena.capacity() == 1024 && arena.used() == 0);
+
+	char* a = static_cast<char*>(arena.allocate(3, 1));
+	void* b = arena.allocate(8, 64);
+	void* c = arena.allocate(1, 16);
+	CHECK(aligned(b, 64) && aligned(c, 16) && static_cast<char*>(b) >= a + 3);
+
+	// Exhaustion throws and leaves the arena as it was.
+	const size_t used = arena.used();
+	bool threw = false;
+	try {
+		(void)arena.allocate(arena.remaining() + 1, 1);
+	}
+	catch (const std::bad_alloc&) {
+		threw = true;
+	}
+	CHECK(threw && arena.used() == used);
+	void* rest = arena.allocate(arena.remaining(), 1);
+	CHECK(rest != nullptr && arena.remaining() == 0);
+
+	// Only the most recent allocation is given back.
+	arena.deallocate(b, 8);
+	CHECK(arena.remaining() == 0);
+	arena.deallocate(rest, static_cast<size_t>(arena.capacity() - used));
+	CHECK(arena.used() == used);
+
+	// try_extend grows the most recent allocation while there is room, nothing else.
+	void* last = arena.allocate(16, 1);
+	CHECK(arena.try_extend(last, 16, 64) && arena.used() == used + 64);
+	CHECK(!arena.try_extend(c, 1, 2));
+	CHECK(!arena.try_extend(last, 64, arena.capacity()));
+
+	{
+		sad::stack_arena::scope scope(arena);
+		(void)arena.allocate(100);
+		CHECK(arena.used() > used + 64);
+	}
+	CHECK(arena.used() == used + 64);
+	arena.rewind(arena.mark());
+	arena.reset();
+	CHECK(arena.used() == 0);
+}
+
+// A null buffer makes the arena take its block from the heap and free it on destruction.
+static void heap_fallback()
+{
+	sad::stack_arena arena(nullptr, 4096);
+	CHECK(!arena.on_stack() && arena.capacity() == 4096);
+	void* ptr = arena.allocate(4000, 256);
+	CHECK(ptr != nullptr && aligned(ptr, 256) && !in_stack(ptr));
+
+	sad::stack_arena empty(nullptr, 0);
+	CHECK(empty.capacity() == 0 && empty.remaining() == 0);
+}
+
+// arena_vectors sharing one arena, the most recent one growing without moving.
+static void vectors()
+{
+	sad::fixed_stack_arena<8192> arena;
+	sad::arena_vector<int> first{ sad::arena_allocator<int>(arena) };
+	first.push_back(1);
+	const int* data = first.data();
+	for (int i = 0; i < 500; i++)
+		first.push_back(i);
+	CHECK(first.data() == data && first.size() == 501);
+
+	// A second vector takes the top, so the first one has to move once it grows.
+	sad::arena_vector<double, 4> second{ sad::arena_allocator<double>(arena) };
+	for (int i = 0; i < 10; i++)
+		second.push_back(i);
+	CHECK(!second.is_inline() && aligned(second.data(), alignof(double)));
+
+	while (first.size() < first.capacity())
+		first.push_back(0);
+	const size_t used = arena.used();
+	const size_t size = first.size();
+	first.push_back(-1);
+	CHECK(first.data() != data && first.back() == -1 && first[500] == 499 && arena.used() > used);
+
+	bool threw = false;
+	try {
+		first.resize(arena.capacity());
+	}
+	catch (const std::bad_alloc&) {
+		threw = true;
+	}
+	CHECK(threw && first.size() == size + 1);
+}
+
+int main()
+{
+	budget();
+	allocation();
+	heap_fallback();
+	vectors();
+
+	if (failures == 0)
+		std::printf("All arena checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,200 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <concurrent_stack_vector.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+static const std::uint32_t threads = 4;
+static const std::uint32_t per_thread = 20000;
+
+// Value appended by thread t as its i'th element, never 0.
+static std::uint32_t tag(std::uint32_t t, std::uint32_t i) { return (t << 24) | (i + 1); }
+
+// Producers appending one at a time, in batches and through reserve_n, while a reader keeps
+// checking that the published prefix is fully written.
+static void appends()
+{
+	static sad::concurrent_stack_vector<std::uint32_t, threads * per_thread> values;
+	std::atomic<bool> done(false);
+	std::atomic<bool> torn(false);
+
+	std::thread reader([&]() {
+		size_t checked = 0;
+		while (!done.load()) {
+			const size_t size = values.size();
+			for (; checked < size; checked++) {
+				if (values[checked] == 0)
+					torn = true;
+			}
+			std::this_thread::yield();
+		}
+	});
+
+	std::vector<std::thread> producers;
+	for (std::uint32_t t = 0; t < threads; t++) {
+		producers.emplace_back([t]() {
+			std::uint32_t i = 0;
+			while (i < per_thread) {
+				if (i % 3 == 0) {
+					values.push_back(tag(t, i++));
+				}
+				else if (i % 3 == 1 && i + 4 <= per_thread) {
+					const std::uint32_t batch[4] = { tag(t, i), tag(t, i + 1), tag(t, i + 2), tag(t, i + 3) };
+					values.append(batch, 4);
+					i += 4;
+				}
+				else {
+					auto slots = values.reserve_n(1);
+					slots.emplace_back(tag(t, i++));
+					slots.commit();
+				}
+			}
+		});
+	}
+	for (std::thread& producer : producers)
+		producer.join();
+	done = true;
+	reader.join();
+
+	CHECK(!torn);
+	CHECK(values.size() == threads * per_thread);
+
+	// Every value exactly once, and each thread's values in the order it appended them.
+	std::vector<std::uint32_t> seen(threads * per_thread, 0);
+	std::vector<std::uint32_t> last(threads, 0);
+	bool ordered = true;
+	for (std::uint32_t value : values) {
+		const std::uint32_t t = value >> 24;
+		const std::uint32_t i = (value & 0xFFFFFF) - 1;
+		seen[t * per_thread + i]++;
+		ordered = ordered && (value & 0xFFFFFF) > last[t];
+		last[t] = value & 0xFFFFFF;
+	}
+	bool once = true;
+	for (std::uint32_t count : seen)
+		once = once && count == 1;
+	CHECK(once);
+	CHECK(ordered);
+}
+
+// More appends than fit: the ones past N fail, the vector ends up exactly full and stays so.
+static void overflow()
+{
+	sad::concurrent_stack_vector<std::string, 1000> names;
+	std::atomic<size_t> accepted(0);
+
+	std::vector<std::thread> producers;
+	for (std::uint32_t t = 0; t < threads; t++) {
+		producers.emplace_back([&names, &accepted]() {
+			for (int i = 0; i < 400; i++) {
+				if (names.emplace_back("a name long enough to allocate its characters"))
+					accepted++;
+			}
+		});
+	}
+	for (std::thread& producer : producers)
+		producer.join();
+
+	CHECK(accepted == 1000);
+	CHECK(names.size() == 1000);
+	CHECK(!names.push_back("one more"));
+
+	names.clear();
+	CHECK(names.empty());
+	CHECK(names.push_back("after clear") && names.size() == 1 && names[0] == "after clear");
+}
+
+// A batch dropped half constructed can't be published, and neither can anything after it.
+static void abandoned()
+{
+	sad::concurrent_stack_vector<int, 16> values;
+	CHECK(values.push_back(1));
+	{
+		auto slots = values.reserve_n(3);
+		CHECK(static_cast<bool>(slots));
+		slots.emplace_back(2);
+	}
+	CHECK(!values.push_back(3));
+	CHECK(values.size() == 1);
+
+	// A batch fully constructed but never committed is published on destruction.
+	values.clear();
+	{
+		auto slots = values.reserve_n(2);
+		slots.emplace_back(4);
+		slots.emplace_back(5);
+	}
+	CHECK(values.size() == 2 && values[0] == 4 && values[1] == 5);
+	CHECK(!values.reserve_n(15));
+}
+
+// Batches committed out of reservation order, as happens when one thread holds two and they go
+// out of scope in reverse: the later one waits as ready and goes out with the earlier one.
+static void out_of_order()
+{
+	sad::concurrent_stack_vector<std::string, 16> names;
+	{
+		auto first = names.reserve_n(2);
+		auto second = names.reserve_n(1);
+		first.emplace_back("a name long enough to allocate its characters");
+		first.emplace_back("b");
+		second.emplace_back("c");
+		CHECK(second.commit());
+		CHECK(names.empty());
+	}
+	CHECK(names.size() == 3 && names[0][0] == 'a' && names[1] == "b" && names[2] == "c");
+
+	// A ready batch stuck behind an abandoned one is never published, but still destroyed.
+	{
+		auto first = names.reserve_n(2);
+		auto second = names.reserve_n(1);
+		second.emplace_back("a name long enough to allocate its characters");
+		CHECK(second.commit());
+		first.emplace_back("d");
+	}
+	CHECK(names.size() == 3 && !names.push_back("e"));
+
+	names.clear();
+	CHECK(names.push_back("after clear") && names.size() == 1);
+
+	// Every thread holding two batches and committing them in reverse.
+	static sad::concurrent_stack_vector<std::uint32_t, threads * per_thread> values;
+	std::vector<std::thread> producers;
+	for (std::uint32_t t = 0; t < threads; t++) {
+		producers.emplace_back([t]() {
+			for (std::uint32_t i = 0; i < per_thread; i += 2) {
+				auto first = values.reserve_n(1);
+				auto second = values.reserve_n(1);
+				second.emplace_back(tag(t, i + 1));
+				first.emplace_back(tag(t, i));
+			}
+		});
+	}
+	for (std::thread& producer : producers)
+		producer.join();
+
+	CHECK(values.size() == threads * per_thread);
+	bool written = true;
+	for (std::uint32_t value : values)
+		written = written && value != 0;
+	CHECK(written);
+}
+
+int main()
+{
+	appends();
+	overflow();
+	abandoned();
+	out_of_order();
+
+	if (failures == 0)
+		std::printf("All concurrent_stack_vector checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
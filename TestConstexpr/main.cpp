@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <cstdio>
+
+#include <stack_vector.hpp>
+
+// Everything here is checked by the compiler, the program only runs to report it.
+static_assert(SAD_CONSTEXPR_VECTOR, "stack_vector is only constexpr from C++20 on");
+
+constexpr sad::stack_vector<std::uint32_t, 32> sobol_directions()
+{
+	sad::stack_vector<std::uint32_t, 32> directions;
+	for (std::uint32_t i = 0; i < 32; i++)
+		directions.push_back(1u << (31 - i));
+	return directions;
+}
+
+constexpr sad::stack_vector<float, 16> kernel()
+{
+	sad::stack_vector<float, 16> taps;
+	taps.emplace_back(1.0f);
+	taps.emplace_back(4.0f);
+	taps.emplace_back(1.0f);
+	taps.insert(taps.begin(), 0.5f);                // 0.5 1 4 1
+	taps.insert(taps.end(), 0.5f);                  // 0.5 1 4 1 0.5
+	taps.erase(taps.begin() + 2);                   // 0.5 1 1 0.5
+	taps.resize(6, 2.0f);                           // 0.5 1 1 0.5 2 2
+	taps.pop_back();                                // 0.5 1 1 0.5 2
+
+	sad::stack_vector<float, 16> copy = taps;
+	copy[0] = 3.0f;
+	taps.swap(copy);                                // 3 1 1 0.5 2
+	taps.unordered_erase(taps.begin() + 1);         // 3 2 1 0.5
+	return taps;
+}
+
+constexpr int ranges()
+{
+	const int values[] = { 1, 2, 3, 4 };
+	sad::stack_vector<int, 8> vec;
+	vec.append_range(values);
+	vec.append_range(values);
+	vec.assign_range(values);
+
+	int sum = 0;
+	for (int value : vec)
+		sum += value;
+	return sum;
+}
+
+// Allocating vectors work too, as long as they are gone by the end of the evaluation.
+template<typename Growth>
+constexpr int allocating()
+{
+	sad::stack_vector<int, 0, void, Growth> vec;
+	for (int i = 0; i < 100; i++)
+		vec.push_back(i);
+	vec.insert(vec.begin(), -1);
+	vec.erase(vec.begin() + 5);
+
+	int sum = 0;
+	for (int value : vec)
+		sum += value;
+	return sum;
+}
+
+constexpr bool comparisons()
+{
+	sad::stack_vector<int, 8> a, b;
+	a.push_back(1);
+	a.push_back(2);
+	b.push_back(1);
+	b.push_back(3);
+	const sad::stack_vector<int, 8> c(a);
+	return a < b && a == c && a != b && b > a && a <= c && a.compare(b) < 0;
+}
+
+constexpr auto directions = sobol_directions();
+constexpr auto taps = kernel();
+
+static_assert(directions.size() == 32 && directions[0] == 0x80000000u && directions.back() == 1u, "push_back");
+static_assert(taps.size() == 4 && taps[0] == 3.0f && taps[1] == 2.0f && taps[2] == 1.0f && taps[3] == 0.5f, "insert/erase/resize/swap");
+static_assert(ranges() == 10, "append_range/assign_range");
+static_assert(allocating<sad::growth::geometric>() == 4950 - 1 - 4, "geometric growth");
+static_assert(allocating<sad::growth::exact>() == 4950 - 1 - 4, "exact growth");
+static_assert(allocating<sad::growth::hinted<>>() == 4950 - 1 - 4, "hinted growth");
+static_assert(comparisons(), "comparisons");
+
+int main()
+{
+	std::printf("%zu directions and %zu taps built at compile time\n", directions.size(), taps.size());
+	return 0;
+}
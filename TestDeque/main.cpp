@@ -0,0 +1,195 @@
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <stack_deque.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+// Counts live instances so leaks and double destruction show up as a non-zero balance.
+struct tracked
+{
+	static int live;
+	int value;
+
+	tracked(int v) : value(v) { live++; }
+	tracked(const tracked& other) : value(other.value) { live++; }
+	tracked(tracked&& other) noexcept : value(other.value) { other.value = -1; live++; }
+	tracked& operator=(const tracked&) = default;
+	tracked& operator=(tracked&&) = default;
+	~tracked() { live--; }
+};
+
+int tracked::live = 0;
+
+template<typename Deque>
+static bool matches(const Deque& deque, const std::deque<int>& reference)
+{
+	if (deque.size() != reference.size())
+		return false;
+	for (size_t i = 0; i < reference.size(); i++)
+		if (deque[i].value != reference[i])
+			return false;
+	return true;
+}
+
+// Random pushes and pops at both ends against std::deque, which exercises recentering whenever
+// one end runs out of headroom.
+static void both_ends()
+{
+	{
+		sad::stack_deque<tracked, 16> deque;
+		std::deque<int> reference;
+		std::mt19937 rng(3);
+
+		bool valid = true;
+		for (int op = 0; op < 20000; op++) {
+			const unsigned choice = rng() % 4;
+			if (choice < 2 && !deque.full()) {
+				if (choice == 0) {
+					deque.push_back(tracked(op));
+					reference.push_back(op);
+				}
+				else {
+					deque.emplace_front(op);
+					reference.push_front(op);
+				}
+			}
+			else if (!deque.empty()) {
+				if (choice == 2) {
+					deque.pop_back();
+					reference.pop_back();
+				}
+				else {
+					deque.pop_front();
+					reference.pop_front();
+				}
+			}
+			valid = valid && matches(deque, reference) && tracked::live == static_cast<int>(reference.size());
+		}
+		CHECK(valid);
+	}
+	CHECK(tracked::live == 0);
+}
+
+// A full FIFO keeps running out of back headroom and must keep working.
+static void fifo()
+{
+	sad::stack_deque<int, 8> deque;
+	for (int i = 0; i < 7; i++)
+		deque.push_back(i);
+
+	bool valid = true;
+	int next = 0;
+	for (int i = 7; i < 1000; i++) {
+		valid = valid && deque.front() == next;
+		deque.pop_front();
+		next++;
+		deque.push_back(i);
+		valid = valid && deque.back() == i && deque.size() == 7;
+		valid = valid && deque.front_headroom() + deque.size() + deque.back_headroom() == deque.capacity();
+	}
+	CHECK(valid);
+
+	int expected = next;
+	bool ordered = true;
+	for (int value : deque)
+		ordered = ordered && value == expected++;
+	CHECK(ordered);
+	CHECK(deque.view().size() == 7 && deque.view().data() == deque.data());
+
+	deque.push_front(-1);
+	CHECK(deque.full() && deque.front() == -1);
+
+	bool threw = false;
+	try {
+		deque.push_back(0);
+	}
+	catch (const std::length_error&) {
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK(deque.size() == 8);
+}
+
+static void copy_and_move()
+{
+	{
+		sad::stack_deque<tracked, 8> deque;
+		std::deque<int> reference;
+		for (int i = 0; i < 3; i++) {
+			deque.emplace_front(i);
+			deque.emplace_back(10 + i);
+			reference.push_front(i);
+			reference.push_back(10 + i);
+		}
+
+		sad::stack_deque<tracked, 8> copy(deque);
+		CHECK(matches(copy, reference));
+
+		sad::stack_deque<tracked, 8> moved(std::move(copy));
+		CHECK(matches(moved, reference));
+
+		sad::stack_deque<tracked, 8> assigned;
+		assigned.emplace_back(99);
+		assigned = deque;
+		CHECK(matches(assigned, reference));
+
+		assigned.clear();
+		CHECK(assigned.empty());
+		assigned = std::move(moved);
+		CHECK(matches(assigned, reference));
+		CHECK(matches(deque, reference));
+	}
+	CHECK(tracked::live == 0);
+}
+
+// Pushing one of the deque's own elements when that end is at the edge: the argument has to be
+// read before re-centering moves it.
+static void self_push()
+{
+	sad::stack_deque<std::string, 16> deque;
+	int next = 0;
+	while (deque.back_headroom() > 0)
+		deque.push_back("value number " + std::to_string(next++));
+
+	std::string expected = deque[0];
+	deque.push_back(deque[0]);
+	CHECK(deque.back() == expected);
+
+	while (deque.front_headroom() > 0)
+		deque.push_front("value number " + std::to_string(next++));
+	expected = deque[5];
+	deque.push_front(deque[5]);
+	CHECK(deque.front() == expected);
+
+	while (deque.back_headroom() > 0)
+		deque.push_back("value number " + std::to_string(next++));
+	expected = deque[3];
+	deque.emplace_back(deque[3]);
+	CHECK(deque.back() == expected && deque.full());
+
+	sad::stack_deque<int, 4> numbers;
+	numbers.push_back(10);
+	numbers.push_back(12);
+	CHECK(numbers.back_headroom() == 0);
+	numbers.push_back(numbers.front());
+	CHECK(numbers.size() == 3 && numbers.back() == 10);
+}
+
+int main()
+{
+	both_ends();
+	fifo();
+	copy_and_move();
+	self_push();
+
+	if (failures == 0)
+		std::printf("All deque checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
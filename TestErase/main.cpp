@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <erase_batch.hpp>
+#include <memory_resource.hpp>
+#include <small_vector.hpp>
+#include <stack_arena.hpp>
+#include <stack_vector.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+static int make(int i, int) { return i; }
+static std::string make(int i, std::string) { return "value " + std::to_string(i); }
+
+template<typename Vector, typename T>
+static bool matches(const Vector& vector, const std::vector<T>& reference)
+{
+	return vector.size() == reference.size() && std::equal(reference.begin(), reference.end(), vector.begin());
+}
+
+// Marks random elements (some twice), appends while marks are pending, and flushes, comparing
+// against std::vector after each round. Runs for both the memmove and the element-wise compaction.
+template<typename T, typename Vector>
+static void batch()
+{
+	Vector vector;
+	std::vector<T> reference;
+	std::mt19937 rng(5);
+
+	bool valid = true;
+	int next = 0;
+	for (int round = 0; round < 200; round++) {
+		while (vector.size() < 150) {
+			vector.push_back(make(next, T()));
+			reference.push_back(make(next, T()));
+			next++;
+		}
+
+		std::vector<bool> marked(vector.size(), false);
+		sad::erase_batch<Vector> batch(vector);
+		const size_t marks = rng() % vector.size();
+		for (size_t i = 0; i < marks; i++) {
+			const size_t index = rng() % vector.size();
+			batch.erase(index);
+			marked[index] = true;
+		}
+		const size_t expected = static_cast<size_t>(std::count(marked.begin(), marked.end(), true));
+		valid = valid && batch.pending() == expected;
+		valid = valid && (marks == 0 || batch.erased(vector.size() - 1) == marked.back());
+
+		// Appended elements are never marked, so they survive the flush.
+		for (int i = 0; i < 3; i++) {
+			vector.push_back(make(next, T()));
+			reference.push_back(make(next, T()));
+			marked.push_back(false);
+			next++;
+		}
+
+		size_t kept = 0;
+		for (size_t i = 0; i < reference.size(); i++)
+			if (!marked[i])
+				reference[kept++] = reference[i];
+		reference.resize(kept);
+
+		valid = valid && batch.flush() == expected && batch.pending() == 0;
+		valid = valid && matches(vector, reference);
+	}
+	CHECK(valid);
+
+	// The destructor flushes whatever is still marked.
+	const size_t size = vector.size();
+	{
+		sad::erase_batch<Vector> batch(vector);
+		batch.erase(0);
+		batch.erase(size - 1);
+		batch.erase(0);
+		CHECK(batch.pending() == 2);
+	}
+	CHECK(vector.size() == size - 2);
+}
+
+template<typename T, typename Vector>
+static void erase_functions()
+{
+	Vector vector;
+	std::vector<T> reference;
+	for (int i = 0; i < 200; i++) {
+		vector.push_back(make(i % 10, T()));
+		reference.push_back(make(i % 10, T()));
+	}
+
+	const T three = make(3, T());
+	CHECK(sad::erase(vector, three) == 20);
+	reference.erase(std::remove(reference.begin(), reference.end(), three), reference.end());
+	CHECK(matches(vector, reference));
+
+	const T five = make(5, T());
+	CHECK(sad::erase_if(vector, [&five](const T& value) { return value < five; }) == 80);
+	reference.erase(std::remove_if(reference.begin(), reference.end(), [&five](const T& value) { return value < five; }), reference.end());
+	CHECK(matches(vector, reference));
+
+	// Marks straddling the 64 bit word boundary.
+	std::uint64_t mask[2] = { 0, 0 };
+	const size_t marked[] = { 0, 1, 31, 62, 63, 64, 65 };
+	for (size_t index : marked)
+		mask[index / 64] |= std::uint64_t(1) << (index % 64);
+	CHECK(vector.erase_marked(mask) == 7);
+	for (size_t i = sizeof(marked) / sizeof(marked[0]); i-- > 0;)
+		reference.erase(reference.begin() + marked[i]);
+	CHECK(matches(vector, reference));
+
+	// unordered_erase keeps the same elements, just not their order.
+	const T erased = vector[4];
+	vector.unordered_erase(vector.begin() + 4);
+	reference.erase(std::find(reference.begin(), reference.end(), erased));
+	std::vector<T> sorted(vector.begin(), vector.end());
+	std::sort(sorted.begin(), sorted.end());
+	std::sort(reference.begin(), reference.end());
+	CHECK(sorted == reference);
+
+	vector.unordered_erase(vector.end() - 1);
+	CHECK(vector.size() == reference.size() - 1);
+}
+
+// Resource counting what goes through it, on top of the heap.
+class counting_resource : public sad::memory_resource
+{
+public:
+	size_t allocations = 0;
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override
+	{
+		allocations++;
+		return sad::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+	{
+		sad::new_delete_resource()->deallocate(ptr, bytes, alignment);
+	}
+};
+
+// Marks that outgrow their inline words come from the vector's own allocator.
+static void allocators()
+{
+	sad::fixed_stack_arena<4096> arena;
+	sad::arena_vector<int, 8> in_arena{ sad::arena_allocator<int>(arena) };
+	for (int i = 0; i < 200; i++)
+		in_arena.push_back(i);
+	{
+		sad::erase_batch<decltype(in_arena)> batch(in_arena);
+		const size_t used = arena.used();
+		for (size_t i = 0; i < in_arena.size(); i += 2)
+			batch.erase(i);
+		CHECK(arena.used() > used);
+		CHECK(noexcept(batch.flush()));
+	}
+	CHECK(in_arena.size() == 100 && in_arena[0] == 1 && in_arena[99] == 199);
+
+	counting_resource resource;
+	sad::pmr::stack_vector<int, 8> in_resource{ sad::polymorphic_allocator<int>(&resource) };
+	for (int i = 0; i < 200; i++)
+		in_resource.push_back(i);
+	const size_t allocations = resource.allocations;
+	{
+		sad::erase_batch<decltype(in_resource)> batch(in_resource);
+		batch.erase(150);
+		CHECK(resource.allocations > allocations);
+
+		// Appended after the marks last grew, kept by the flush.
+		in_resource.push_back(200);
+	}
+	CHECK(in_resource.size() == 200 && in_resource[150] == 151 && in_resource.back() == 200);
+}
+
+int main()
+{
+	batch<int, sad::stack_vector<int, 256>>();
+	batch<std::string, sad::stack_vector<std::string, 256>>();
+	batch<int, sad::small_vector<int, 16>>();
+	batch<std::string, sad::small_vector<std::string, 16>>();
+
+	erase_functions<int, sad::stack_vector<int, 256>>();
+	erase_functions<std::string, sad::stack_vector<std::string, 256>>();
+	erase_functions<std::string, sad::small_vector<std::string, 8>>();
+
+	allocators();
+
+	if (failures == 0)
+		std::printf("All erase checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stack_flat_map.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+template<typename Key>
+static Key make_key(std::uint32_t n) { return static_cast<Key>(n); }
+
+template<>
+std::string make_key<std::string>(std::uint32_t n) { return "key " + std::to_string(n); }
+
+template<typename Map, typename Reference>
+static bool same(const Map& map, const Reference& reference)
+{
+	if (map.size() != reference.size())
+		return false;
+
+	auto it = reference.begin();
+	for (auto entry : map) {
+		if (entry.first != it->first || entry.second != it->second)
+			return false;
+		++it;
+	}
+	return true;
+}
+
+// Random inserts, erases and lookups against std::map, growing past the linear search threshold
+// so both the counting and the binary search are used.
+template<typename Key, typename Compare = std::less<Key>>
+static void against_std_map(std::uint32_t keys, unsigned seed)
+{
+	sad::stack_flat_map<Key, int, 0, Compare> map;
+	std::map<Key, int, Compare> reference;
+	std::mt19937 rng(seed);
+
+	bool agree = true;
+	for (int op = 0; op < 20000; op++) {
+		const Key key = make_key<Key>(rng() % keys);
+		switch (rng() % 5) {
+		case 0:
+		case 1:
+			agree = agree && map.insert(key, op).second == reference.insert(std::make_pair(key, op)).second;
+			break;
+		case 2:
+			map.insert_or_assign(key, op);
+			reference[key] = op;
+			break;
+		case 3:
+			agree = agree && map.erase(key) == reference.erase(key);
+			break;
+		default: {
+			const int* value = map.get(key);
+			auto found = reference.find(key);
+			agree = agree && (value == nullptr) == (found == reference.end()) && (value == nullptr || *value == found->second);
+
+			auto lower = map.lower_bound(key);
+			auto upper = map.upper_bound(key);
+			agree = agree && static_cast<size_t>(lower - map.begin()) == static_cast<size_t>(std::distance(reference.begin(), reference.lower_bound(key)));
+			agree = agree && static_cast<size_t>(upper - map.begin()) == static_cast<size_t>(std::distance(reference.begin(), reference.upper_bound(key)));
+			break;
+		}
+		}
+	}
+	CHECK(agree);
+	CHECK(same(map, reference));
+}
+
+static void sets()
+{
+	std::mt19937 rng(7);
+	sad::stack_flat_set<int, 256> a, b;
+	std::set<int> ra, rb;
+	for (int i = 0; i < 100; i++) {
+		const int x = static_cast<int>(rng() % 200);
+		const int y = static_cast<int>(rng() % 200);
+		a.insert(x);
+		ra.insert(x);
+		b.insert(y);
+		rb.insert(y);
+	}
+
+	std::vector<int> expected;
+	std::set_union(ra.begin(), ra.end(), rb.begin(), rb.end(), std::back_inserter(expected));
+	const auto both = set_union(a, b);
+	CHECK(std::vector<int>(both.begin(), both.end()) == expected);
+
+	expected.clear();
+	std::set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(), std::back_inserter(expected));
+	const auto common = set_intersection(a, b);
+	CHECK(std::vector<int>(common.begin(), common.end()) == expected);
+
+	expected.clear();
+	std::set_difference(ra.begin(), ra.end(), rb.begin(), rb.end(), std::back_inserter(expected));
+	const auto only_a = set_difference(a, b);
+	CHECK(std::vector<int>(only_a.begin(), only_a.end()) == expected);
+
+	// A sorted batch with duplicates merges in one pass.
+	std::vector<int> batch;
+	for (int i = 150; i < 260; i += 3)
+		batch.push_back(i);
+	batch.push_back(batch.back());
+	a.insert_sorted_range(batch.begin(), batch.end());
+	ra.insert(batch.begin(), batch.end());
+	CHECK(std::vector<int>(a.begin(), a.end()) == std::vector<int>(ra.begin(), ra.end()));
+}
+
+static void maps()
+{
+	sad::stack_flat_map<std::string, int, 16> map{ { "b", 2 }, { "a", 1 }, { "c", 3 } };
+	CHECK(map.size() == 3 && map.begin()->first == "a");
+	CHECK(map.at("b") == 2);
+
+	bool threw = false;
+	try {
+		(void)map.at("z");
+	}
+	catch (const std::out_of_range&) {
+		threw = true;
+	}
+	CHECK(threw);
+
+	map["d"] = 4;
+	CHECK(map.contains("d") && map.values()[3] == 4);
+
+	// Keys already there keep their value.
+	const std::pair<std::string, int> batch[] = { { "a", 10 }, { "aa", 11 }, { "e", 5 } };
+	map.insert_sorted_range(batch, batch + 3);
+	CHECK(map.size() == 6 && map.at("a") == 1 && map.at("aa") == 11);
+
+	sad::stack_flat_map<std::string, int, 16> other{ { "a", 100 }, { "x", 24 } };
+	const auto merged = set_union(map, other);
+	CHECK(merged.size() == 7 && merged.at("a") == 1 && merged.at("x") == 24);
+	CHECK(set_intersection(map, other).size() == 1);
+	CHECK(set_difference(map, other).size() == 5);
+
+	map.erase(map.find("aa"));
+	CHECK(!map.contains("aa") && map.size() == 5);
+}
+
+int main()
+{
+	against_std_map<std::int32_t>(64, 1);
+	against_std_map<std::int32_t>(5000, 2);
+	against_std_map<float>(64, 3);
+	against_std_map<double>(5000, 4);
+	against_std_map<std::string>(300, 5);
+	against_std_map<std::int32_t, std::greater<std::int32_t>>(300, 6);
+	sets();
+	maps();
+
+	if (failures == 0)
+		std::printf("All flat map checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include <stack_hash_map.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+// Counts live values, to catch elements destroyed twice or never.
+static int live = 0;
+
+struct counted
+{
+	int value;
+
+	counted(int value = 0) : value(value) { live++; }
+	counted(const counted& other) : value(other.value) { live++; }
+	counted(counted&& other) noexcept : value(other.value) { live++; }
+	counted& operator=(const counted&) = default;
+	~counted() { live--; }
+};
+
+static int value_of(const counted& v) { return v.value; }
+static int value_of(int v) { return v; }
+
+template<typename Key>
+static Key make_key(std::uint32_t n) { return static_cast<Key>(n); }
+
+template<>
+std::string make_key<std::string>(std::uint32_t n) { return "a key long enough to allocate " + std::to_string(n); }
+
+// Random inserts and erases against std::unordered_map with the table kept nearly full, so erased
+// slots pile up and have to be cleaned up in place.
+template<typename Key, typename Value, std::size_t N>
+static void churn(std::uint32_t keys, int ops, unsigned seed)
+{
+	sad::stack_hash_map<Key, Value, N> map;
+	std::unordered_map<Key, int> reference;
+	std::mt19937 rng(seed);
+
+	bool agree = true;
+	for (int op = 0; op < ops; op++) {
+		const Key key = make_key<Key>(rng() % keys);
+		if (rng() % 2 == 0 && map.size() < N)
+			agree = agree && map.try_emplace(key, op).second == reference.emplace(key, op).second;
+		else
+			agree = agree && map.erase(key) == reference.erase(key);
+
+		if (op % 1000 == 0) {
+			for (const auto& entry : reference) {
+				const Value* value = map.get(entry.first);
+				agree = agree && value != nullptr && value_of(*value) == entry.second;
+			}
+			size_t walked = 0;
+			for (const auto& entry : map)
+				walked += reference.count(entry.first);
+			agree = agree && walked == reference.size() && map.size() == reference.size();
+		}
+	}
+	CHECK(agree);
+
+	// Misses still end, and end correctly, after all the churn.
+	bool missing = true;
+	for (std::uint32_t i = keys; i < keys + 1000; i++)
+		missing = missing && !map.contains(make_key<Key>(i));
+	CHECK(missing);
+}
+
+struct seeded_hash
+{
+	size_t seed;
+
+	seeded_hash(size_t seed = 0) : seed(seed) {}
+	size_t operator()(int key) const { return static_cast<size_t>(key) * 31 + seed; }
+};
+
+static void copies()
+{
+	sad::stack_hash_map<int, std::string, 32, seeded_hash> a(seeded_hash(7));
+	for (int i = 0; i < 20; i++)
+		a.try_emplace(i, std::to_string(i));
+
+	sad::stack_hash_map<int, std::string, 32, seeded_hash> b(a);
+	CHECK(b.size() == 20 && b.hash_function().seed == 7 && *b.get(13) == "13");
+
+	sad::stack_hash_map<int, std::string, 32, seeded_hash> c(seeded_hash(99));
+	c.try_emplace(100, "gone");
+	c = a;
+	CHECK(c.size() == 20 && c.hash_function().seed == 7 && !c.contains(100) && *c.get(19) == "19");
+}
+
+static void basics()
+{
+	{
+		sad::stack_hash_map<int, counted, 64> map;
+		for (int i = 0; i < 64; i++)
+			map[i] = counted(i);
+
+		bool threw = false;
+		try {
+			map.try_emplace(64, 64);
+		}
+		catch (const std::length_error&) {
+			threw = true;
+		}
+		CHECK(threw);
+
+		// Erase every other element while walking.
+		for (auto it = map.begin(); it != map.end();) {
+			if (it->first % 2 == 0)
+				it = map.erase(it);
+			else
+				++it;
+		}
+		CHECK(map.size() == 32 && !map.contains(10) && map.contains(11));
+
+		map.insert_or_assign(11, counted(-11));
+		CHECK(map.get(11)->value == -11);
+
+		// Clearing often enough for the generation to wrap around.
+		for (int round = 0; round < 600; round++) {
+			map.clear();
+			map.try_emplace(round, round);
+		}
+		CHECK(map.size() == 1 && map.get(599)->value == 599);
+	}
+	CHECK(live == 0);
+}
+
+int main()
+{
+	churn<int, int, 1787>(6000, 400000, 1);
+	churn<int, counted, 223>(600, 100000, 2);
+	churn<std::string, int, 200>(500, 50000, 3);
+	CHECK(live == 0);
+	copies();
+	basics();
+
+	if (failures == 0)
+		std::printf("All hash map checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
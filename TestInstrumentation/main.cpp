@@ -0,0 +1,122 @@
+#include <cstdio>
+
+#include <stack_vector.hpp>
+#include <small_vector.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+template<typename Vector>
+static sad::instrumentation::stats& stats_of()
+{
+	return sad::instrumentation::detail::type_stats<Vector>();
+}
+
+// Inline-only vectors never reallocate, their buffer is part of the object.
+static void inline_only()
+{
+	typedef sad::stack_vector<int, 16> vector;
+	stats_of<vector>().reset();
+
+	for (int n = 0; n < 5; n++) {
+		vector vec;
+		for (int i = 0; i < 16; i++)
+			vec.push_back(i);
+		vec.resize(8);
+		vec.clear();
+	}
+
+	CHECK(stats_of<vector>().instances() == 5);
+	CHECK(stats_of<vector>().reallocations() == 0);
+	CHECK(stats_of<vector>().peak_capacity() == 16);
+	CHECK(stats_of<vector>().peak_stack_bytes() == 16 * sizeof(int));
+}
+
+// Peak stack bytes are the inline bytes holding elements, not the size of the object.
+static void stack_bytes()
+{
+	typedef sad::stack_vector<double, 64> vector;
+	stats_of<vector>().reset();
+
+	{
+		vector vec;
+		CHECK(stats_of<vector>().peak_stack_bytes() == 0);
+
+		for (int i = 0; i < 3; i++)
+			vec.push_back(i);
+		vec.insert(vec.begin(), 2, 1.0);
+		CHECK(stats_of<vector>().peak_stack_bytes() == 5 * sizeof(double));
+
+		vec.clear();
+		vec.push_back(1.0);
+		CHECK(stats_of<vector>().peak_stack_bytes() == 5 * sizeof(double));
+
+		vec.resize(10);
+		CHECK(stats_of<vector>().peak_stack_bytes() == 10 * sizeof(double));
+	}
+
+	// Elements that spilled to the heap don't take any stack.
+	typedef sad::small_vector<double, 4> small;
+	stats_of<small>().reset();
+	{
+		small vec;
+		for (int i = 0; i < 100; i++)
+			vec.push_back(i);
+		CHECK(stats_of<small>().peak_stack_bytes() == 4 * sizeof(double));
+	}
+}
+
+// A small_vector reallocates once when it spills, and again each time the heap block grows.
+static void spilling()
+{
+	typedef sad::small_vector<int, 4> vector;
+	stats_of<vector>().reset();
+
+	{
+		vector vec;
+		for (int i = 0; i < 4; i++)
+			vec.push_back(i);
+		CHECK(stats_of<vector>().reallocations() == 0);
+
+		vec.push_back(4);
+		CHECK(stats_of<vector>().reallocations() == 1);
+		CHECK(stats_of<vector>().peak_capacity() > 4);
+	}
+
+	{
+		vector vec;
+		vector copy(vec);
+		vector moved(std::move(copy));
+		CHECK(stats_of<vector>().reallocations() == 1);
+	}
+}
+
+static void copies_and_moves()
+{
+	typedef sad::stack_vector<int, 8> vector;
+	stats_of<vector>().reset();
+
+	vector vec;
+	for (int i = 0; i < 6; i++)
+		vec.push_back(i);
+
+	vector copy(vec);
+	CHECK(stats_of<vector>().copied() == 6);
+
+	vector moved(std::move(copy));
+	CHECK(stats_of<vector>().moved() == 6);
+	CHECK(stats_of<vector>().reallocations() == 0);
+}
+
+int main()
+{
+	inline_only();
+	stack_bytes();
+	spilling();
+	copies_and_moves();
+
+	if (failures == 0)
+		std::printf("All instrumentation checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
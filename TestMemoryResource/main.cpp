@@ -0,0 +1,177 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <memory_resource.hpp>
+#include <small_vector.hpp>
+#include <stack_arena.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+struct alignas(64) block64
+{
+	float values[16];
+};
+
+// Resource counting what goes through it, on top of another one.
+class counting_resource : public sad::memory_resource
+{
+public:
+	explicit counting_resource(sad::memory_resource* upstream) : m_upstream(upstream) {}
+
+	size_t allocations = 0;
+	size_t deallocations = 0;
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override
+	{
+		allocations++;
+		return m_upstream->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+	{
+		deallocations++;
+		m_upstream->deallocate(ptr, bytes, alignment);
+	}
+
+	bool do_try_extend(void* ptr, size_t old_bytes, size_t new_bytes) override
+	{
+		return m_upstream->try_extend(ptr, old_bytes, new_bytes);
+	}
+
+private:
+	sad::memory_resource* m_upstream;
+};
+
+static int constructs = 0;
+static int destroys = 0;
+
+// Allocator counting the elements built and torn down through it.
+template<typename T>
+struct counting_allocator : std::allocator<T>
+{
+	template<typename U>
+	struct rebind { using other = counting_allocator<U>; };
+
+	counting_allocator() = default;
+	template<typename U>
+	counting_allocator(const counting_allocator<U>&) noexcept {}
+
+	template<typename U, typename... Args>
+	void construct(U* ptr, Args&&... args)
+	{
+		constructs++;
+		::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+	}
+
+	template<typename U>
+	void destroy(U* ptr)
+	{
+		destroys++;
+		ptr->~U();
+	}
+};
+
+static bool aligned(const void* ptr, size_t alignment)
+{
+	return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+// Over-aligned elements keep their alignment through every resource.
+static void alignment()
+{
+	sad::memory_resource* heap = sad::new_delete_resource();
+	bool all_aligned = true;
+	for (size_t bytes = 1; bytes < 4096; bytes = bytes * 3 + 1) {
+		const size_t alignments[] = { 1, 8, alignof(std::max_align_t), 64, 256, 4096 };
+		for (size_t alignment : alignments) {
+			void* ptr = heap->allocate(bytes, alignment);
+			all_aligned = all_aligned && aligned(ptr, alignment);
+			static_cast<char*>(ptr)[bytes - 1] = 1;
+			heap->deallocate(ptr, bytes, alignment);
+		}
+	}
+	CHECK(all_aligned);
+
+	sad::pmr::stack_vector<block64, 2> blocks;
+	for (int i = 0; i < 100; i++) {
+		blocks.push_back(block64());
+		all_aligned = all_aligned && aligned(blocks.data(), 64);
+	}
+	CHECK(all_aligned && !blocks.is_inline());
+
+	sad::fixed_stack_arena<16384> arena;
+	sad::arena_resource on_arena(arena);
+	sad::pmr::stack_vector<block64> in_arena{ sad::polymorphic_allocator<block64>(&on_arena) };
+	in_arena.resize(10);
+	CHECK(aligned(in_arena.data(), 64));
+}
+
+// Vectors take their storage from the resource they were given, and give it all back.
+static void resources()
+{
+	counting_resource counter(sad::new_delete_resource());
+	{
+		sad::pmr::stack_vector<std::string, 4> names{ sad::polymorphic_allocator<std::string>(&counter) };
+		for (int i = 0; i < 4; i++)
+			names.push_back("inline name " + std::to_string(i));
+		CHECK(counter.allocations == 0);
+
+		for (int i = 4; i < 100; i++)
+			names.push_back("spilled name " + std::to_string(i));
+		CHECK(counter.allocations > 0 && names[99] == "spilled name 99");
+
+		// Copies start out on the default resource, like std::pmr.
+		sad::pmr::stack_vector<std::string, 4> copy(names);
+		CHECK(copy.get_allocator().resource() == sad::new_delete_resource() && copy.size() == 100);
+		CHECK(names.get_allocator() == sad::polymorphic_allocator<int>(&counter));
+		CHECK(names.get_allocator() != copy.get_allocator());
+	}
+	CHECK(counter.allocations == counter.deallocations);
+
+	// On an arena the most recent block grows in place.
+	sad::fixed_stack_arena<4096> arena;
+	sad::arena_resource on_arena(arena);
+	counting_resource arena_counter(&on_arena);
+	sad::pmr::stack_vector<int> numbers{ sad::polymorphic_allocator<int>(&arena_counter) };
+	numbers.reserve(16);
+	const int* first = numbers.data();
+	for (int i = 0; i < 500; i++)
+		numbers.push_back(i);
+	CHECK(numbers.data() == first && arena_counter.allocations == 1);
+	CHECK(sad::arena_resource(arena) != on_arena && *sad::new_delete_resource() == *sad::new_delete_resource());
+}
+
+// Every element is built and destroyed through allocator_traits, inline ones included.
+static void construction()
+{
+	{
+		sad::small_vector<std::string, 4, counting_allocator<std::string>> names;
+		for (int i = 0; i < 3; i++)
+			names.emplace_back("a name long enough to allocate its characters");
+		CHECK(constructs == 3);
+
+		for (int i = 0; i < 10; i++)
+			names.push_back(names.back());
+		names.erase(names.begin());
+		names.insert(names.begin() + 2, std::string("inserted"));
+		CHECK(constructs > 13 && names[2] == "inserted");
+	}
+	CHECK(constructs == destroys);
+}
+
+int main()
+{
+	alignment();
+	resources();
+	construction();
+
+	if (failures == 0)
+		std::printf("All memory resource checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
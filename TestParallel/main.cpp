@@ -0,0 +1,187 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <parallel.hpp>
+#include <stack_vector.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+static void algorithms(sad::parallel::thread_pool& pool)
+{
+	sad::stack_vector<std::uint32_t> values;
+	for (std::uint32_t i = 0; i < 100000; i++)
+		values.push_back(i);
+
+	sad::parallel::for_each(pool, values, [](std::uint32_t& value) { value *= 2; });
+	bool doubled = true;
+	for (std::uint32_t i = 0; i < values.size(); i++)
+		doubled = doubled && values[i] == i * 2;
+	CHECK(doubled);
+
+	sad::stack_vector<std::uint64_t> squares;
+	squares.resize(values.size());
+	sad::parallel::transform(pool, values, squares, [](std::uint32_t value) { return std::uint64_t(value) * value; });
+	bool squared = true;
+	for (std::uint32_t i = 0; i < squares.size(); i++)
+		squared = squared && squares[i] == std::uint64_t(i * 2) * (i * 2);
+	CHECK(squared);
+
+	const std::uint64_t sum = sad::parallel::reduce(pool, values, std::uint64_t(0), [](std::uint64_t a, std::uint64_t b) { return a + b; });
+	CHECK(sum == 99999ull * 100000ull);
+
+	const std::uint64_t odd = sad::parallel::transform_reduce(pool, values, std::uint64_t(0),
+		[](std::uint64_t a, std::uint64_t b) { return a + b; },
+		[](std::uint32_t value) { return std::uint64_t(value / 2 % 2); });
+	CHECK(odd == 50000);
+
+	// Nothing to do, and too little to split.
+	sad::stack_vector<int> empty;
+	sad::parallel::for_each(pool, empty, [](int&) {});
+	CHECK(sad::parallel::reduce(pool, empty, 7, [](int a, int b) { return a + b; }) == 7);
+
+	sad::stack_vector<int, 3> tiny;
+	tiny.push_back(1);
+	tiny.push_back(2);
+	tiny.push_back(3);
+	CHECK(sad::parallel::reduce(pool, tiny, 0, [](int a, int b) { return a + b; }) == 6);
+}
+
+// Every element lands in exactly one chunk, each chunk on one worker.
+static void chunks(sad::parallel::thread_pool& pool)
+{
+	sad::stack_vector<float> values;
+	values.resize(12345, 1.0f);
+
+	sad::parallel::per_worker<size_t> counted(pool, 0);
+	std::atomic<size_t> chunk_count(0);
+	sad::parallel::for_each_chunk(pool, values, [&](sad::span<float> chunk, size_t worker) {
+		for (float& value : chunk)
+			value += 1.0f;
+		counted[worker] += chunk.size();
+		chunk_count++;
+	});
+
+	size_t total = 0;
+	for (size_t i = 0; i < counted.size(); i++)
+		total += counted[i];
+	CHECK(total == values.size());
+	CHECK(chunk_count > 1);
+
+	bool once = true;
+	for (float value : values)
+		once = once && value == 2.0f;
+	CHECK(once);
+}
+
+// The first exception reaches the caller, and the pool keeps working afterwards.
+static void exceptions(sad::parallel::thread_pool& pool)
+{
+	bool caught = false;
+	try {
+		pool.run(64, [](size_t chunk, size_t) {
+			if (chunk == 17)
+				throw std::runtime_error("chunk 17");
+		});
+	}
+	catch (const std::runtime_error&) {
+		caught = true;
+	}
+	CHECK(caught);
+
+	std::atomic<size_t> ran(0);
+	pool.run(64, [&](size_t, size_t) { ran++; });
+	CHECK(ran == 64);
+}
+
+// A job started from inside a job runs on the calling worker instead of deadlocking.
+static void nested(sad::parallel::thread_pool& pool)
+{
+	std::atomic<size_t> inner(0);
+	pool.run(8, [&](size_t, size_t) {
+		pool.run(4, [&](size_t, size_t) { inner++; });
+	});
+	CHECK(inner == 32);
+}
+
+// Many small jobs back to back, to shake out races between finishing one job and starting the next.
+static void stress(sad::parallel::thread_pool& pool)
+{
+	bool all = true;
+	for (int round = 0; round < 2000; round++) {
+		std::atomic<size_t> ran(0);
+		pool.run(static_cast<size_t>(round % 37 + 1), [&](size_t, size_t) { ran++; });
+		all = all && ran == static_cast<size_t>(round % 37 + 1);
+	}
+	CHECK(all);
+}
+
+// Flags a worker slot as in use, copyable so per_worker can hold it.
+struct busy_flag
+{
+	std::atomic<bool> m_busy{ false };
+
+	busy_flag() = default;
+	busy_flag(const busy_flag&) {}
+};
+
+// Jobs from several outside threads share worker 0, so a single chunk one must not run while
+// another job is using that worker's per_worker slot.
+static void external_callers(sad::parallel::thread_pool& pool)
+{
+	sad::parallel::per_worker<busy_flag> busy(pool);
+	std::atomic<bool> overlapped(false);
+	std::atomic<bool> wrong_worker(false);
+
+	auto body = [&](size_t, size_t worker) {
+		if (worker != sad::parallel::this_worker())
+			wrong_worker = true;
+		if (busy[worker].m_busy.exchange(true))
+			overlapped = true;
+		std::this_thread::yield();
+		busy[worker].m_busy = false;
+	};
+
+	std::vector<std::thread> callers;
+	for (int t = 0; t < 3; t++) {
+		callers.emplace_back([&, t]() {
+			for (int round = 0; round < 500; round++)
+				pool.run(t == 0 ? 1 : 16, body);
+		});
+	}
+	for (std::thread& caller : callers)
+		caller.join();
+
+	CHECK(!overlapped);
+	CHECK(!wrong_worker);
+
+	// Called from a worker of another pool, the caller still counts as worker 0 of this one.
+	sad::parallel::thread_pool other(2);
+	other.run(8, [&](size_t, size_t) { pool.run(1, body); });
+	CHECK(!overlapped && !wrong_worker);
+}
+
+int main()
+{
+	sad::parallel::thread_pool pool(4);
+	algorithms(pool);
+	chunks(pool);
+	exceptions(pool);
+	nested(pool);
+	stress(pool);
+	external_callers(pool);
+
+	// The default pool, one worker per hardware thread.
+	sad::stack_vector<int> ones;
+	ones.resize(1000, 1);
+	CHECK(sad::parallel::reduce(ones, 0, [](int a, int b) { return a + b; }) == 1000);
+
+	if (failures == 0)
+		std::printf("All parallel checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
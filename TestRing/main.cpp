@@ -0,0 +1,155 @@
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <stack_ring.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+// One producer and one consumer thread, element by element and in batches; every value has to
+// come out once and in order.
+static void spsc()
+{
+	const std::uint32_t count = 1000000;
+	sad::stack_ring<std::uint32_t, 256> ring;
+
+	std::thread producer([&ring, count]() {
+		std::uint32_t next = 0;
+		std::uint32_t batch[13];
+		while (next < count) {
+			if (next % 2 == 0) {
+				if (!ring.try_push(next))
+					std::this_thread::yield();
+				else
+					next++;
+				continue;
+			}
+
+			std::uint32_t n = 0;
+			for (; n < 13 && next + n < count; n++)
+				batch[n] = next + n;
+			const size_t pushed = ring.push_n(batch, n);
+			next += static_cast<std::uint32_t>(pushed);
+			if (pushed == 0)
+				std::this_thread::yield();
+		}
+	});
+
+	std::uint32_t expected = 0;
+	bool ordered = true;
+	std::uint32_t batch[7];
+	while (expected < count) {
+		const size_t popped = ring.pop_n(batch, 7);
+		for (size_t i = 0; i < popped; i++)
+			ordered = ordered && batch[i] == expected++;
+
+		std::uint32_t value;
+		if (ring.try_pop(value))
+			ordered = ordered && value == expected++;
+		else if (popped == 0)
+			std::this_thread::yield();
+	}
+	producer.join();
+
+	CHECK(ordered);
+	CHECK(ring.empty());
+}
+
+// Both ends on one thread, wrapping around the buffer many times.
+static void single_thread()
+{
+	sad::stack_ring<std::string, 8, sad::ring::single_thread> ring;
+	CHECK(ring.empty());
+
+	int next = 0;
+	int expected = 0;
+	bool ordered = true;
+	for (int round = 0; round < 1000; round++) {
+		while (ring.try_push(std::to_string(next)))
+			next++;
+		CHECK(ring.full());
+
+		std::string out[3];
+		const size_t popped = ring.pop_n(out, 3);
+		for (size_t i = 0; i < popped; i++)
+			ordered = ordered && out[i] == std::to_string(expected++);
+
+		const std::string batch[2] = { std::to_string(next), std::to_string(next + 1) };
+		next += static_cast<int>(ring.push_n(batch, 2));
+
+		std::string* front = ring.peek();
+		ordered = ordered && front != nullptr && *front == std::to_string(expected);
+	}
+	CHECK(ordered);
+
+	ring.clear();
+	CHECK(ring.empty());
+	CHECK(ring.peek() == nullptr);
+
+	std::string out;
+	CHECK(!ring.try_pop(out));
+	CHECK(ring.try_push("again") && ring.try_pop(out) && out == "again");
+}
+
+// A move that throws half way through pop_n frees exactly the slots it got through.
+static int live = 0;
+static int moves_left = 0;
+
+struct fragile
+{
+	int value;
+
+	fragile(int value = 0) : value(value) { live++; }
+	fragile(const fragile& other) : value(other.value) { live++; }
+	~fragile() { live--; }
+
+	fragile& operator=(fragile&& other)
+	{
+		if (moves_left-- == 0)
+			throw std::runtime_error("move");
+		value = other.value;
+		return *this;
+	}
+};
+
+static void throwing_pop()
+{
+	{
+		sad::stack_ring<fragile, 8, sad::ring::single_thread> ring;
+		const fragile in[5] = { 1, 2, 3, 4, 5 };
+		CHECK(ring.push_n(in, 5) == 5);
+
+		fragile out[5];
+		moves_left = 2;
+		bool threw = false;
+		try {
+			ring.pop_n(out, 5);
+		}
+		catch (const std::runtime_error&) {
+			threw = true;
+		}
+		CHECK(threw);
+		CHECK(ring.size() == 3);
+		CHECK(ring.peek() != nullptr && ring.peek()->value == 3);
+
+		moves_left = 1000;
+		fragile rest;
+		CHECK(ring.try_pop(rest) && rest.value == 3);
+	}
+	CHECK(live == 0);
+}
+
+int main()
+{
+	spsc();
+	single_thread();
+	throwing_pop();
+
+	if (failures == 0)
+		std::printf("All ring checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
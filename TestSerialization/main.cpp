@@ -0,0 +1,159 @@
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include <serialization.hpp>
+#include <small_vector.hpp>
+#include <stack_vector.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+struct particle
+{
+	float position[3];
+	std::uint32_t id;
+};
+
+static const char* path = "test_serialization.bin";
+
+static std::vector<unsigned char> read_file(const char* file)
+{
+	std::vector<unsigned char> bytes;
+	if (std::FILE* f = std::fopen(file, "rb")) {
+		int c;
+		while ((c = std::fgetc(f)) != EOF)
+			bytes.push_back(static_cast<unsigned char>(c));
+		std::fclose(f);
+	}
+	return bytes;
+}
+
+static void write_file(const char* file, const std::vector<unsigned char>& bytes)
+{
+	if (std::FILE* f = std::fopen(file, "wb")) {
+		std::fwrite(bytes.data(), 1, bytes.size(), f);
+		std::fclose(f);
+	}
+}
+
+// save_binary, load_binary and mapped_view all agree on the same file.
+static void round_trip()
+{
+	sad::small_vector<particle, 8> saved;
+	for (std::uint32_t i = 0; i < 1000; i++) {
+		const float f = static_cast<float>(i);
+		saved.push_back(particle{ { f, f * 2, f * 3 }, i });
+	}
+	CHECK(sad::save_binary(path, saved) == sad::serial_status::ok);
+
+	sad::small_vector<particle, 8> loaded;
+	loaded.push_back(particle{ { 0, 0, 0 }, 12345 });
+	CHECK(sad::load_binary(path, loaded) == sad::serial_status::ok);
+	CHECK(loaded.size() == saved.size());
+
+	bool same = true;
+	for (size_t i = 0; i < saved.size(); i++)
+		same = same && loaded[i].id == saved[i].id && loaded[i].position[2] == saved[i].position[2];
+	CHECK(same);
+
+	sad::mapped_view<particle> view;
+	CHECK(!view.is_open() && view.empty());
+	CHECK(view.open(path) == sad::serial_status::ok);
+	CHECK(view.is_open() && view.size() == saved.size());
+	CHECK(reinterpret_cast<std::uintptr_t>(view.data()) % alignof(particle) == 0);
+	CHECK(view.front().id == 0 && view.back().id == 999 && view[500].position[1] == 1000.0f);
+
+	std::uint32_t sum = 0;
+	for (const particle& p : view)
+		sum += p.id;
+	CHECK(sum == 999 * 1000 / 2);
+
+	sad::mapped_view<particle> moved(std::move(view));
+	CHECK(!view.is_open() && moved.is_open() && moved.view().size() == 1000);
+	moved.close();
+	CHECK(!moved.is_open() && moved.empty());
+
+	// Spans and raw pointers write the same file, and so does an empty vector.
+	CHECK(sad::save_binary(path, saved.data() + 10, 5) == sad::serial_status::ok);
+	CHECK(sad::load_binary(path, loaded) == sad::serial_status::ok);
+	CHECK(loaded.size() == 5 && loaded[0].id == 10 && loaded[4].id == 14);
+
+	sad::stack_vector<particle, 4> empty;
+	CHECK(sad::save_binary(path, empty) == sad::serial_status::ok);
+	CHECK(sad::load_binary(path, loaded) == sad::serial_status::ok && loaded.empty());
+	CHECK(view.open(path) == sad::serial_status::ok && view.is_open() && view.empty());
+	view.close();
+
+	std::remove(path);
+}
+
+// Each way a file can be wrong reports its own status and leaves the vector empty.
+static void errors()
+{
+	sad::stack_vector<int, 64> loaded;
+	sad::mapped_view<int> view;
+
+	std::remove(path);
+	CHECK(sad::load_binary(path, loaded) == sad::serial_status::io_error);
+	CHECK(view.open(path) == sad::serial_status::io_error && !view.is_open());
+
+	sad::stack_vector<int, 64> saved;
+	for (int i = 0; i < 64; i++)
+		saved.push_back(i * i);
+	CHECK(sad::save_binary(path, saved) == sad::serial_status::ok);
+	const std::vector<unsigned char> good = read_file(path);
+	CHECK(!good.empty());
+
+	sad::stack_vector<std::int64_t, 64> wide;
+	CHECK(sad::load_binary(path, wide) == sad::serial_status::type_mismatch);
+
+	sad::stack_vector<int, 16> small;
+	CHECK(sad::load_binary(path, small) == sad::serial_status::too_large && small.empty());
+
+	// Flip a bit in the last element.
+	std::vector<unsigned char> bytes = good;
+	bytes.back() ^= 1;
+	write_file(path, bytes);
+	loaded.push_back(1);
+	CHECK(sad::load_binary(path, loaded) == sad::serial_status::checksum_mismatch && loaded.empty());
+	CHECK(view.open(path) == sad::serial_status::checksum_mismatch && !view.is_open());
+	CHECK(view.open(path, false) == sad::serial_status::ok && view.size() == 64);
+	view.close();
+
+	// Drop the last element.
+	bytes = good;
+	bytes.resize(bytes.size() - sizeof(int));
+	write_file(path, bytes);
+	CHECK(sad::load_binary(path, loaded) == sad::serial_status::truncated);
+	CHECK(view.open(path) == sad::serial_status::truncated);
+
+	// A newer format version, then not a save_binary file at all.
+	bytes = good;
+	bytes[4] ^= 0x80;
+	write_file(path, bytes);
+	CHECK(sad::load_binary(path, loaded) == sad::serial_status::version_mismatch);
+
+	bytes.assign(good.size(), 'x');
+	write_file(path, bytes);
+	CHECK(sad::load_binary(path, loaded) == sad::serial_status::bad_header);
+	CHECK(view.open(path) == sad::serial_status::bad_header);
+
+	bytes.resize(4);
+	write_file(path, bytes);
+	CHECK(sad::load_binary(path, loaded) == sad::serial_status::bad_header && loaded.empty());
+
+	std::remove(path);
+}
+
+int main()
+{
+	round_trip();
+	errors();
+
+	if (failures == 0)
+		std::printf("All serialization checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <stack_slot_map.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+// Random inserts and erases, checking every handle ever handed out: live ones find their own
+// element, erased ones are rejected even after their slot is reused.
+static void handles()
+{
+	struct issued
+	{
+		sad::slot_handle handle;
+		std::string value;
+		bool alive;
+	};
+
+	sad::stack_slot_map<std::string, 128> map;
+	std::vector<issued> all;
+	std::mt19937 rng(1);
+
+	bool valid = true;
+	for (int op = 0; op < 20000; op++) {
+		if (rng() % 2 == 0 && map.size() < map.capacity()) {
+			const std::string value = "element " + std::to_string(op);
+			all.push_back(issued{ map.insert(value), value, true });
+		}
+		else if (!all.empty()) {
+			issued& victim = all[rng() % all.size()];
+			valid = valid && map.erase(victim.handle) == victim.alive;
+			victim.alive = false;
+		}
+
+		if (op % 500 == 0) {
+			size_t alive = 0;
+			for (const issued& entry : all) {
+				const std::string* value = map.get(entry.handle);
+				valid = valid && map.contains(entry.handle) == entry.alive;
+				valid = valid && (entry.alive ? value != nullptr && *value == entry.value : value == nullptr);
+				alive += entry.alive ? 1 : 0;
+			}
+			valid = valid && alive == map.size();
+		}
+	}
+	CHECK(valid);
+
+	// The packed array and handle_at agree.
+	bool packed = true;
+	for (size_t i = 0; i < map.size(); i++)
+		packed = packed && &map[map.handle_at(i)] == &map.values()[i];
+	CHECK(packed);
+
+	const sad::slot_handle stale = map.handle_at(0);
+	map.clear();
+	CHECK(map.empty() && !map.contains(stale) && map.get(stale) == nullptr);
+}
+
+static void capacity()
+{
+	sad::stack_slot_map<int, 4> map;
+	const sad::slot_handle none;
+	CHECK(!map.contains(none));
+
+	for (int i = 0; i < 4; i++)
+		map.emplace(i);
+
+	bool threw = false;
+	try {
+		map.emplace(4);
+	}
+	catch (const std::length_error&) {
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK(map.size() == 4);
+
+	int sum = 0;
+	for (int value : map)
+		sum += value;
+	CHECK(sum == 6);
+}
+
+int main()
+{
+	handles();
+	capacity();
+
+	if (failures == 0)
+		std::printf("All slot map checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
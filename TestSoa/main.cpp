@@ -0,0 +1,173 @@
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include <soa_stack_vector.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+struct float3
+{
+	float x;
+	float y;
+	float z;
+};
+
+// Counts live instances and throws from its constructor once the countdown reaches zero.
+struct tracked
+{
+	static int live;
+	static int countdown;
+
+	std::string value;
+
+	explicit tracked(const std::string& v) : value(v) { _tick(); live++; }
+	tracked(const tracked& other) : value(other.value) { _tick(); live++; }
+	tracked(tracked&& other) noexcept : value(std::move(other.value)) { live++; }
+	tracked& operator=(const tracked&) = default;
+	~tracked() { live--; }
+
+	static void _tick()
+	{
+		if (countdown > 0 && --countdown == 0)
+			throw std::runtime_error("tracked");
+	}
+};
+
+int tracked::live = 0;
+int tracked::countdown = 0;
+
+template<typename T>
+static bool aligned(const T* pointer)
+{
+	return reinterpret_cast<std::uintptr_t>(pointer) % SAD_SOA_ALIGNMENT == 0;
+}
+
+static void plain_fields()
+{
+	sad::soa_stack_vector<8, int, double, std::string> vec;
+	CHECK(vec.empty() && vec.capacity() == 8);
+
+	vec.push_back(std::make_tuple(1, 1.5, std::string("one")));
+	vec.emplace_back(2, 2.5, "two");
+	CHECK(vec.size() == 2);
+	CHECK(std::get<0>(vec[1]) == 2 && std::get<1>(vec[1]) == 2.5 && std::get<2>(vec[1]) == "two");
+
+	std::get<0>(vec[0]) = 10;
+	CHECK(vec.data<0>()[0] == 10);
+
+	CHECK(aligned(vec.data<0>()) && aligned(vec.data<1>()) && aligned(vec.data<2>()));
+
+	auto names = vec.field<2>();
+	CHECK(names.size() == 2 && names[0] == "one" && names[1] == "two");
+
+	sad::soa_stack_vector<8, int, double, std::string> copy(vec);
+	CHECK(copy.size() == 2 && std::get<2>(copy[0]) == "one");
+
+	sad::soa_stack_vector<8, int, double, std::string> moved(std::move(copy));
+	CHECK(moved.size() == 2 && std::get<2>(moved[1]) == "two");
+
+	copy = moved;
+	CHECK(copy.size() == 2 && std::get<0>(copy[0]) == 10);
+
+	vec.pop_back();
+	CHECK(vec.size() == 1);
+	vec.clear();
+	CHECK(vec.empty());
+
+	bool threw = false;
+	for (int i = 0; i < 8; i++)
+		vec.emplace_back(i, 0.0, "");
+	try {
+		vec.emplace_back(8, 0.0, "");
+	}
+	catch (const std::length_error&) {
+		threw = true;
+	}
+	CHECK(threw && vec.size() == 8);
+}
+
+static void struct_fields()
+{
+	sad::soa_stack_vector<16, SAD_SOA_MEMBER(float3, x), SAD_SOA_MEMBER(float3, y), SAD_SOA_MEMBER(float3, z)> points;
+
+	for (int i = 0; i < 16; i++) {
+		float3 p = { float(i), float(i * 2), float(i * 3) };
+		points.push_back(p);
+	}
+
+	float3 p = points.get(5);
+	CHECK(p.x == 5.0f && p.y == 10.0f && p.z == 15.0f);
+
+	float sum = 0.0f;
+	for (float y : points.field<1>())
+		sum += y;
+	CHECK(sum == 240.0f);
+	CHECK(aligned(points.data<2>()));
+}
+
+// A field constructor that throws must take the fields already built for that element with it.
+static void throwing_fields()
+{
+	{
+		sad::soa_stack_vector<4, tracked, tracked, tracked> vec;
+		vec.emplace_back("a", "b", "c");
+		CHECK(tracked::live == 3);
+
+		// Throw on the second field, after the first one was built in place.
+		auto element = std::make_tuple(tracked("d"), tracked("e"), tracked("f"));
+		tracked::countdown = 2;
+		bool threw = false;
+		try {
+			vec.push_back(element);
+		}
+		catch (const std::runtime_error&) {
+			threw = true;
+		}
+		CHECK(threw && vec.size() == 1);
+		CHECK(tracked::live == 6);
+
+		vec.push_back(element);
+		CHECK(vec.size() == 2 && tracked::live == 9);
+
+		// Throw on the second field of the second element being copied.
+		tracked::countdown = 5;
+		threw = false;
+		try {
+			sad::soa_stack_vector<4, tracked, tracked, tracked> copy(vec);
+		}
+		catch (const std::runtime_error&) {
+			threw = true;
+		}
+		CHECK(threw && tracked::live == 9);
+
+		sad::soa_stack_vector<4, tracked, tracked, tracked> target;
+		tracked::countdown = 5;
+		threw = false;
+		try {
+			target = vec;
+		}
+		catch (const std::runtime_error&) {
+			threw = true;
+		}
+		CHECK(threw && target.size() == 1 && tracked::live == 12);
+	}
+	CHECK(tracked::live == 0);
+	tracked::countdown = 0;
+}
+
+int main()
+{
+	plain_fields();
+	struct_fields();
+	throwing_fields();
+
+	if (failures == 0)
+		std::printf("All soa_stack_vector checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
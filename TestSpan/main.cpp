@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+#include <span.hpp>
+#include <stack_vector.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+struct float3
+{
+	float x;
+	float y;
+	float z;
+};
+
+template<typename View, typename Expected>
+static bool same(const View& view, const Expected& expected)
+{
+	if (view.size() != expected.size())
+		return false;
+	size_t i = 0;
+	for (auto it = view.begin(); it != view.end(); ++it, ++i)
+		if (*it != expected[i])
+			return false;
+	return true;
+}
+
+static void spans()
+{
+	int array[10];
+	std::iota(array, array + 10, 0);
+
+	sad::span<int> all(array);
+	CHECK(all.size() == 10 && all.size_bytes() == sizeof(array) && !all.empty());
+	CHECK(all.front() == 0 && all.back() == 9 && all[4] == 4);
+	CHECK(sad::span<int>(array + 2, array + 5).size() == 3);
+	CHECK(sad::span<int>().empty() && sad::span<int>().data() == nullptr);
+
+	CHECK(same(all.first(3), std::vector<int>{ 0, 1, 2 }));
+	CHECK(same(all.last(2), std::vector<int>{ 8, 9 }));
+	CHECK(same(all.subspan(7), std::vector<int>{ 7, 8, 9 }));
+	CHECK(same(all.subspan(2, 2), std::vector<int>{ 2, 3 }));
+	CHECK(same(all.slice(4, 6), std::vector<int>{ 4, 5 }));
+	CHECK(all.slice(5, 5).empty() && all.first(0).empty() && all.last(0).empty());
+
+	// Writes through a span land in the container, const spans view any container with data().
+	sad::stack_vector<int, 16> vector(all.begin(), all.end());
+	sad::span<int> mutable_view(vector);
+	mutable_view[0] = 100;
+	CHECK(vector[0] == 100);
+
+	const std::vector<int> reference(array, array + 10);
+	const sad::span<const int> const_view(reference);
+	CHECK(same(const_view, reference));
+}
+
+static void strided()
+{
+	int array[10];
+	std::iota(array, array + 10, 0);
+	sad::span<int> all(array);
+
+	// Rounds up: 0, 3, 6, 9.
+	sad::strided_span<int> every_third = all.strided(3);
+	CHECK(same(every_third, std::vector<int>{ 0, 3, 6, 9 }));
+	CHECK(!every_third.is_contiguous() && every_third.stride() == 3 * static_cast<std::ptrdiff_t>(sizeof(int)));
+	CHECK(every_third.front() == 0 && every_third.back() == 9 && every_third[2] == 6);
+
+	CHECK(same(all.strided(2).strided(2), std::vector<int>{ 0, 4, 8 }));
+	CHECK(same(every_third.first(2), std::vector<int>{ 0, 3 }));
+	CHECK(same(every_third.last(2), std::vector<int>{ 6, 9 }));
+	CHECK(same(every_third.subspan(1, 2), std::vector<int>{ 3, 6 }));
+	CHECK(same(every_third.slice(1, 4), std::vector<int>{ 3, 6, 9 }));
+	CHECK(same(every_third.reversed(), std::vector<int>{ 9, 6, 3, 0 }));
+	CHECK(same(every_third.reversed().reversed(), std::vector<int>{ 0, 3, 6, 9 }));
+	CHECK(every_third.first(0).reversed().empty());
+
+	// Empty views and end() of a wide stride never point past the array.
+	CHECK(every_third.subspan(4).empty() && every_third.subspan(4).data() == array);
+	CHECK(every_third.last(0).data() == array && every_third.slice(4, 4).data() == array);
+	CHECK(every_third.end() - every_third.begin() == 4 && every_third.reversed().end() - every_third.reversed().begin() == 4);
+
+	// A zero stride repeats one element, and still counts its positions.
+	sad::strided_span<int> repeated(array + 4, 5, 0);
+	CHECK(repeated.end() - repeated.begin() == 5 && same(repeated, std::vector<int>{ 4, 4, 4, 4, 4 }));
+
+	sad::strided_span<int> contiguous(all);
+	CHECK(contiguous.is_contiguous() && contiguous.size() == 10 && contiguous.data() == array);
+
+	sad::strided_span<const int> readonly = every_third;
+	CHECK(readonly.size() == 4 && readonly[3] == 9);
+
+	// The iterator is random access.
+	sad::strided_span<int>::iterator it = every_third.begin();
+	CHECK(every_third.end() - it == 4 && it[3] == 9 && *(it + 2) == 6);
+	it += 3;
+	CHECK(*it == 9 && *--it == 6 && it > every_third.begin() && it <= every_third.end());
+
+	for (int& value : every_third)
+		value = -value;
+	CHECK(array[3] == -3 && array[4] == 4 && array[9] == -9);
+}
+
+static void members()
+{
+	sad::stack_vector<float3, 8> points;
+	for (int i = 0; i < 8; i++) {
+		const float f = static_cast<float>(i);
+		points.push_back(float3{ f, 10 - f, f * f });
+	}
+
+	sad::strided_span<float> xs = sad::strided_member(points, &float3::x);
+	sad::strided_span<float> ys = sad::strided_member(points, &float3::y);
+	CHECK(xs.size() == 8 && xs.stride() == static_cast<std::ptrdiff_t>(sizeof(float3)));
+	CHECK(xs[5] == 5.0f && ys[5] == 5.0f && &xs[5] == &points[5].x);
+	CHECK(std::accumulate(xs.begin(), xs.end(), 0.0f) == 28.0f);
+
+	// Sorting one member leaves the others in place.
+	std::sort(ys.begin(), ys.end());
+	CHECK(ys.front() == 3.0f && ys.back() == 10.0f && points[0].x == 0.0f && points[7].z == 49.0f);
+
+	const sad::stack_vector<float3, 8>& readonly = points;
+	sad::strided_span<const float> zs = sad::strided_member(readonly, &float3::z);
+	CHECK(zs.back() == 49.0f);
+
+	sad::span<float3> view(points);
+	CHECK(sad::strided_member(view.last(2), &float3::z).front() == 36.0f);
+
+	sad::stack_vector<float3, 8> none;
+	CHECK(sad::strided_member(none, &float3::x).empty());
+}
+
+int main()
+{
+	spans();
+	strided();
+	members();
+
+	if (failures == 0)
+		std::printf("All span checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
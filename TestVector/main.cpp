@@ -0,0 +1,307 @@
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <small_vector.hpp>
+#include <stack_vector.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+// Counts live instances, and throws from the copy constructor once copies_left runs out.
+template<bool Relocatable>
+struct thrower
+{
+	static int live;
+	static int copies_left;
+	int value;
+
+	thrower(int v) : value(v) { live++; }
+	thrower(const thrower& other) : value(other.value)
+	{
+		if (copies_left-- == 0)
+			throw std::runtime_error("copy");
+		live++;
+	}
+	thrower(thrower&& other) noexcept : value(other.value) { live++; }
+	thrower& operator=(const thrower&) = default;
+	thrower& operator=(thrower&&) = default;
+	~thrower() { live--; }
+};
+
+template<bool Relocatable>
+int thrower<Relocatable>::live = 0;
+template<bool Relocatable>
+int thrower<Relocatable>::copies_left = -1;
+
+namespace sad {
+	template<>
+	struct is_trivially_relocatable<thrower<true>> : std::true_type {};
+}
+
+static std::string name(int i) { return "element number " + std::to_string(i); }
+
+// Appending one of the vector's own elements when it is full: the argument has to be read
+// before growing frees the buffer it lives in.
+template<typename Vector>
+static void self_append()
+{
+	Vector vector;
+	while (vector.size() < 4 || vector.size() < vector.capacity())
+		vector.push_back(name(static_cast<int>(vector.size())));
+
+	size_t size = vector.size();
+	vector.push_back(vector[0]);
+	CHECK(vector.size() == size + 1 && vector.back() == name(0));
+
+	while (vector.size() < vector.capacity())
+		vector.push_back(name(0));
+	size = vector.size();
+	vector.emplace_back(vector[1]);
+	CHECK(vector.size() == size + 1 && vector.back() == name(1));
+
+	while (vector.size() < vector.capacity())
+		vector.push_back(name(0));
+	size = vector.size();
+	vector.push_back(std::move(vector[2]));
+	CHECK(vector.size() == size + 1 && vector.back() == name(2));
+
+	while (vector.size() < vector.capacity())
+		vector.push_back(name(0));
+	size = vector.size();
+	vector.insert(vector.cend(), vector[3]);
+	CHECK(vector.size() == size + 1 && vector.back() == name(3));
+}
+
+template<typename Vector>
+static bool unchanged(const Vector& vector, int size)
+{
+	if (vector.size() != static_cast<size_t>(size))
+		return false;
+	for (int i = 0; i < size; i++)
+		if (vector[i].value != i)
+			return false;
+	return true;
+}
+
+// A copy throwing half way through an insert leaves the vector as it was, with nothing leaked or
+// destroyed twice. Runs for the memmove and the element-wise gap.
+template<typename T, typename Vector>
+static void insert_throws()
+{
+	{
+		Vector vector;
+		for (int i = 0; i < 6; i++)
+			vector.emplace_back(i);
+		const std::vector<T> source = { T(100), T(101), T(102), T(103) };
+
+		// Gaps inside the tail, running past its end and at the very end.
+		const size_t positions[] = { 1, 4, 6 };
+		bool rolled_back = true;
+		for (size_t position : positions) {
+			for (int copies = 0; copies < 3; copies++) {
+				int threw = 0;
+				T::copies_left = copies;
+				try {
+					vector.insert(vector.cbegin() + position, source.begin(), source.end());
+				}
+				catch (const std::runtime_error&) {
+					threw++;
+				}
+
+				T::copies_left = copies;
+				try {
+					vector.insert(vector.cbegin() + position, 4, source[0]);
+				}
+				catch (const std::runtime_error&) {
+					threw++;
+				}
+				T::copies_left = -1;
+
+				rolled_back = rolled_back && threw == 2 && unchanged(vector, 6);
+				rolled_back = rolled_back && T::live == 6 + 4;
+			}
+		}
+		CHECK(rolled_back);
+
+		vector.insert(vector.cbegin() + 2, source.begin(), source.end());
+		CHECK(vector.size() == 10 && vector[2].value == 100 && vector[6].value == 2);
+	}
+	CHECK(T::live == 0);
+}
+
+// Grow an N == 0 vector in a frame of its own.
+static sad::stack_vector<std::string> grown(int count)
+{
+	sad::stack_vector<std::string> vector;
+	for (int i = 0; i < count; i++)
+		vector.push_back(name(i));
+	return vector;
+}
+
+// Write over a good deal of stack below the caller.
+static int clobber(int depth)
+{
+	volatile char scratch[1024];
+	std::memset(const_cast<char*>(scratch), 0x5A, sizeof(scratch));
+	return depth == 0 ? scratch[0] : clobber(depth - 1) + scratch[depth % sizeof(scratch)];
+}
+
+// N == 0 keeps its elements in a std::allocator block, which outlives the calls that grew it.
+static void heap_mode()
+{
+	static_assert(std::is_same<sad::stack_vector<int>::allocator_type, std::allocator<int>>::value, "N == 0 allocates with std::allocator");
+
+	sad::stack_vector<std::string> vector = grown(100);
+	CHECK(clobber(32) != 0);
+	vector.push_back(name(100));
+
+	bool intact = vector.size() == 101 && !vector.is_inline();
+	for (int i = 0; i <= 100; i++)
+		intact = intact && vector[i] == name(i);
+	CHECK(intact);
+}
+
+// Only has operator== and operator<, and counts how often they are called.
+struct counted
+{
+	static int calls;
+	int value;
+
+	counted(int v) : value(v) {}
+	bool operator==(const counted& other) const { calls++; return value == other.value; }
+	bool operator<(const counted& other) const { calls++; return value < other.value; }
+};
+
+int counted::calls = 0;
+
+// Comparisons stop at the first difference, order like std::vector, and keep float semantics.
+static void comparisons()
+{
+	sad::stack_vector<counted, 1024> a, b;
+	for (int i = 0; i < 1000; i++) {
+		a.push_back(counted(i));
+		b.push_back(counted(i == 0 ? -1 : i));
+	}
+	counted::calls = 0;
+	CHECK(a != b);
+	CHECK(counted::calls == 1);
+	counted::calls = 0;
+	CHECK(b < a && a.compare(b) > 0);
+	CHECK(counted::calls <= 4);
+
+	// -0.0 equals 0.0 and NaN equals nothing, so floats must not take the memcmp path.
+	static_assert(!sad::is_trivially_comparable<float>::value, "floats compare by value");
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	sad::stack_vector<float, 4> zero, negative_zero, with_nan;
+	zero.push_back(1.0f);
+	zero.push_back(0.0f);
+	negative_zero.push_back(1.0f);
+	negative_zero.push_back(-0.0f);
+	with_nan.push_back(1.0f);
+	with_nan.push_back(nan);
+	CHECK(zero == negative_zero && zero.compare(negative_zero) == 0);
+	CHECK(!(zero < negative_zero) && !(negative_zero < zero));
+	CHECK(with_nan != with_nan && !(with_nan == with_nan));
+	CHECK(!(with_nan < zero) && !(zero < with_nan));
+
+	// The memcmp path finds the difference, but must order by value, not by bytes.
+	std::mt19937 rng(3);
+	for (int round = 0; round < 500; round++) {
+		std::vector<int> ra(rng() % 200);
+		for (int& x : ra)
+			x = int(rng() % 5) - 2;
+		std::vector<int> rb = ra;
+		if (!rb.empty() && rng() % 2 == 0)
+			rb[rng() % rb.size()] = int(rng() % 5) - 2;
+		else
+			rb.resize(rng() % 200, -1);
+
+		sad::stack_vector<int, 256> va(ra.begin(), ra.end());
+		sad::stack_vector<int, 64, std::allocator<int>> vb(rb.begin(), rb.end());
+		const int expected = ra < rb ? -1 : (rb < ra ? 1 : 0);
+		const int got = va.compare(vb);
+		CHECK((got < 0 ? -1 : (got > 0 ? 1 : 0)) == expected);
+		CHECK((va == vb) == (ra == rb));
+		CHECK((va < vb) == (ra < rb) && (va <= vb) == (ra <= rb));
+		CHECK((va > vb) == (ra > rb) && (va >= vb) == (ra >= rb));
+	}
+}
+
+// Growing for overwrite: resize_for_overwrite keeps the old elements, and raw appends only
+// count what commit() is told was written.
+static void uninitialized_growth()
+{
+	sad::stack_vector<std::string, 4, std::allocator<std::string>> names;
+	names.push_back(name(0));
+	names.resize_for_overwrite(10);
+	CHECK(names.size() == 10 && names[0] == name(0) && names[9].empty());
+	names.resize_for_overwrite(1);
+	CHECK(names.size() == 1 && names[0] == name(0));
+
+	sad::stack_vector<int, 8, std::allocator<int>> ints;
+	for (int i = 0; i < 5; i++)
+		ints.push_back(i);
+	ints.resize_for_overwrite(40);
+	CHECK(ints.size() == 40 && !ints.is_inline());
+	bool kept = true;
+	for (int i = 0; i < 5; i++)
+		kept = kept && ints[i] == i;
+	CHECK(kept);
+
+	ints.resize(5);
+	sad::span<int> space = ints.reserve_and_append_uninitialized(100);
+	CHECK(space.size() == 100 && space.data() == ints.data() + 5 && ints.capacity() >= 105);
+	CHECK(ints.size() == 5);
+	for (int i = 0; i < 60; i++)
+		space[i] = 100 + i;
+	ints.commit(60);
+	CHECK(ints.size() == 65 && ints[4] == 4 && ints[5] == 100 && ints.back() == 159);
+
+	ints.commit(0);
+	CHECK(ints.reserve_and_append_uninitialized(0).size() == 0 && ints.size() == 65);
+
+	// A fixed capacity vector can't make room past N.
+	sad::stack_vector<int, 16> fixed;
+	sad::span<int> all = fixed.reserve_and_append_uninitialized(16);
+	for (int i = 0; i < 16; i++)
+		all[i] = i;
+	fixed.commit(16);
+	CHECK(fixed.size() == 16 && fixed[15] == 15);
+
+	bool threw = false;
+	try {
+		(void)fixed.reserve_and_append_uninitialized(1);
+	}
+	catch (const std::length_error&) {
+		threw = true;
+	}
+	CHECK(threw && fixed.size() == 16);
+}
+
+int main()
+{
+	self_append<sad::small_vector<std::string, 4>>();
+	self_append<sad::stack_vector<std::string>>();
+
+	heap_mode();
+	comparisons();
+	uninitialized_growth();
+
+	insert_throws<thrower<false>, sad::stack_vector<thrower<false>, 16>>();
+	insert_throws<thrower<true>, sad::stack_vector<thrower<true>, 16>>();
+	insert_throws<thrower<false>, sad::small_vector<thrower<false>, 4>>();
+	insert_throws<thrower<true>, sad::small_vector<thrower<true>, 4>>();
+
+	if (failures == 0)
+		std::printf("All vector checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <memory>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <stack_vector.hpp>
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+template<typename Bits>
+static bool same(const Bits& bits, const std::vector<bool>& reference)
+{
+	if (bits.size() != reference.size())
+		return false;
+	for (size_t i = 0; i < reference.size(); i++)
+		if (bits[i] != reference[i])
+			return false;
+
+	// Bits past size() must stay clear, whole word operations rely on it.
+	if (bits.size() % 64 != 0 && (bits.word_data()[bits.size() / 64] >> (bits.size() % 64)) != 0)
+		return false;
+	return true;
+}
+
+static size_t reference_find(const std::vector<bool>& reference, size_t from)
+{
+	for (size_t i = from; i < reference.size(); i++)
+		if (reference[i])
+			return i;
+	return size_t(-1);
+}
+
+static void basics()
+{
+	sad::stack_vector<bool, 128, std::allocator<bool>> bits = { true, false, true };
+	CHECK(bits.size() == 3 && bits[0] && !bits[1] && bits[2]);
+	CHECK(bits.front() && bits.back() && bits.count() == 2);
+
+	bits[1] = true;
+	bits[0].flip();
+	CHECK(!bits[0] && bits[1]);
+
+	bits.assign(70, true);
+	CHECK(bits.size() == 70 && bits.count() == 70 && bits.all());
+	bits.pop_back();
+	CHECK(bits.size() == 69 && bits.count() == 69);
+
+	bits.resize(130, true);
+	CHECK(bits.count() == 130 && bits.all() && !bits.is_inline());
+
+	bits.reset();
+	CHECK(bits.none() && !bits.any() && bits.size() == 130);
+	CHECK(bits.find_first() == bits.npos);
+
+	bits.clear();
+	CHECK(bits.empty() && bits.all());
+
+	std::vector<bool> copy(bits.begin(), bits.end());
+	CHECK(copy.empty());
+}
+
+// Random operations, checked against std::vector<bool> after every step. Sizes go past N, so
+// the inline, spilled and N == 0 cases are all covered.
+template<std::size_t N>
+static void against_reference(unsigned seed)
+{
+	std::mt19937 rng(seed);
+	sad::stack_vector<bool, N, std::allocator<bool>> bits;
+	std::vector<bool> reference;
+
+	for (int step = 0; step < 4000; step++) {
+		const unsigned op = rng() % 12;
+		const bool value = rng() % 2 == 0;
+
+		switch (op) {
+		case 0: case 1: case 2:
+			bits.push_back(value);
+			reference.push_back(value);
+			break;
+		case 3:
+			bits.pop_back();
+			if (!reference.empty())
+				reference.pop_back();
+			break;
+		case 4: {
+			const size_t index = rng() % (reference.size() + 1);
+			bits.insert(bits.begin() + index, value);
+			reference.insert(reference.begin() + index, value);
+			break;
+		}
+		case 5:
+			if (!reference.empty()) {
+				const size_t first = rng() % reference.size();
+				const size_t last = first + rng() % (std::min<size_t>(reference.size() - first, 150) + 1);
+				bits.erase(bits.begin() + first, bits.begin() + last);
+				reference.erase(reference.begin() + first, reference.begin() + last);
+			}
+			break;
+		case 6: {
+			const size_t size = rng() % 300;
+			bits.resize(size, value);
+			reference.resize(size, value);
+			break;
+		}
+		case 7:
+			if (!reference.empty()) {
+				const size_t index = rng() % reference.size();
+				bits[index] = value;
+				reference[index] = value;
+			}
+			break;
+		case 8:
+			bits.flip();
+			reference.flip();
+			break;
+		case 9:
+			if (!reference.empty()) {
+				const size_t index = rng() % reference.size();
+				bits.erase(bits.begin() + index);
+				reference.erase(reference.begin() + index);
+			}
+			break;
+		case 10:
+			if (rng() % 8 == 0) {
+				value ? bits.set() : bits.reset();
+				std::fill(reference.begin(), reference.end(), value);
+			}
+			break;
+		default: {
+			const size_t size = rng() % 200;
+			bits.assign(size, value);
+			reference.assign(size, value);
+			break;
+		}
+		}
+
+		if (!same(bits, reference)) {
+			std::printf("seed %u step %d op %u diverged\n", seed, step, op);
+			failures++;
+			return;
+		}
+
+		const size_t set = static_cast<size_t>(std::count(reference.begin(), reference.end(), true));
+		CHECK(bits.count() == set);
+		CHECK(bits.any() == (set != 0));
+		CHECK(bits.all() == (set == reference.size()));
+
+		size_t index = bits.find_first();
+		CHECK(index == reference_find(reference, 0));
+		if (index != bits.npos)
+			CHECK(bits.find_next(index) == reference_find(reference, index + 1));
+	}
+}
+
+static void bitwise()
+{
+	std::mt19937 rng(7);
+	for (size_t size : { 0u, 1u, 63u, 64u, 65u, 200u }) {
+		sad::stack_vector<bool, 64, std::allocator<bool>> a;
+		sad::stack_vector<bool, 256> b;
+		std::vector<bool> ra, rb;
+		for (size_t i = 0; i < size; i++) {
+			const bool x = rng() % 2 == 0, y = rng() % 2 == 0;
+			a.push_back(x);
+			b.push_back(y);
+			ra.push_back(x);
+			rb.push_back(y);
+		}
+
+		std::vector<bool> ran(size), ror(size), rxor(size), rnot(size);
+		for (size_t i = 0; i < size; i++) {
+			ran[i] = ra[i] && rb[i];
+			ror[i] = ra[i] || rb[i];
+			rxor[i] = ra[i] != rb[i];
+			rnot[i] = !ra[i];
+		}
+
+		CHECK(same(a & b, ran));
+		CHECK(same(a | b, ror));
+		CHECK(same(a ^ b, rxor));
+		CHECK(same(~a, rnot));
+	}
+}
+
+// compare() and the relational operators must order like std::vector<bool>.
+static void ordering()
+{
+	std::mt19937 rng(11);
+	for (int round = 0; round < 2000; round++) {
+		std::vector<bool> ra(rng() % 140), rb;
+		for (size_t i = 0; i < ra.size(); i++)
+			ra[i] = rng() % 2 == 0;
+
+		// Mostly compare against a near copy, so the first difference lands anywhere.
+		rb = ra;
+		switch (rng() % 4) {
+		case 0:
+			if (!rb.empty())
+				rb[rng() % rb.size()].flip();
+			break;
+		case 1:
+			rb.resize(rng() % 140, rng() % 2 == 0);
+			break;
+		case 2:
+			break;
+		default:
+			rb.assign(rng() % 140, false);
+			for (size_t i = 0; i < rb.size(); i++)
+				rb[i] = rng() % 2 == 0;
+		}
+
+		sad::stack_vector<bool, 64, std::allocator<bool>> a(ra.size()), b(rb.size());
+		for (bool x : ra) a.push_back(x);
+		for (bool x : rb) b.push_back(x);
+
+		const int expected = ra < rb ? -1 : (rb < ra ? 1 : 0);
+		const int got = a.compare(b);
+		CHECK((got < 0 ? -1 : (got > 0 ? 1 : 0)) == expected);
+		CHECK((a == b) == (ra == rb));
+		CHECK((a != b) == (ra != rb));
+		CHECK((a < b) == (ra < rb));
+		CHECK((a <= b) == (ra <= rb));
+		CHECK((a > b) == (ra > rb));
+		CHECK((a >= b) == (ra >= rb));
+	}
+}
+
+int main()
+{
+	basics();
+	for (unsigned seed = 1; seed <= 8; seed++) {
+		against_reference<64>(seed);
+		against_reference<0>(seed);
+		against_reference<1024>(seed);
+	}
+	bitwise();
+	ordering();
+
+	if (failures == 0)
+		std::printf("All stack_vector<bool> checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
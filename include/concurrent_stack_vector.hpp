@@ -0,0 +1,299 @@
+#ifndef CONCURRENT_STACK_VECTOR_H
+#define CONCURRENT_STACK_VECTOR_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <utility>
+
+#include "span.hpp"
+#include "stack_vector.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	// Fixed-capacity vector of N inline elements that any number of threads can append to at once.
+	// Appending reserves slots with one atomic fetch_add per batch, constructs the elements in
+	// them and then publishes them in reservation order, so readers only ever see the fully
+	// constructed prefix [0, size()). Publishing never waits: a batch finished ahead of an earlier
+	// one only marks its slots ready, and the earlier one publishes both once it is done.
+	// Appends that would go past N fail (returning false) instead of growing, and so does every
+	// later one: the vector is full from then on.
+	// clear() and the destructor must not race with appends.
+	template<typename T, std::size_t N>
+	class concurrent_stack_vector : private detail::inline_storage<T, N>
+	{
+		static_assert(N > 0, "sad::concurrent_stack_vector: N must be greater than 0");
+
+	public:
+		using ValueType = T;
+		using iterator = const T*;
+		using const_iterator = const T*;
+
+		// Slots reserved by one append, filled in order with emplace_back and published by commit
+		// (or on destruction). Converts to false when the reservation did not fit.
+		class batch
+		{
+		public:
+			inline batch(batch&& other) noexcept
+				: m_vector(other.m_vector), m_begin(other.m_begin), m_size(other.m_size), m_constructed(other.m_constructed)
+			{
+				other.m_vector = nullptr;
+			}
+
+			batch(const batch&) = delete;
+			batch& operator=(const batch&) = delete;
+
+			// A batch dropped before all its elements were constructed (say, because a constructor
+			// threw) can't be published, and takes every later append down with it.
+			inline ~batch()
+			{
+				if (m_vector == nullptr)
+					return;
+
+				if (m_constructed == m_size)
+					this->commit();
+				else
+					this->_abandon();
+			}
+
+			_NODISCARD inline explicit operator bool() const noexcept { return m_vector != nullptr; }
+
+			// Number of slots reserved.
+			_NODISCARD inline size_t size() const noexcept { return m_size; }
+
+			// Index in the vector of the first slot.
+			_NODISCARD inline size_t index() const noexcept { return m_begin; }
+
+			// Construct the next element of the batch.
+			template<typename... Args>
+			inline T& emplace_back(Args&&... args)
+			{
+				assert(m_vector != nullptr && m_constructed < m_size);
+
+				T* slot = m_vector->_slot(m_begin + m_constructed);
+				::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+				m_constructed++;
+				return *slot;
+			}
+
+			// Publish the batch, right away if every append reserved before it is published, otherwise
+			// as soon as they are. False if one of those was already abandoned, in which case the batch
+			// is destroyed instead. One abandoned later still keeps it from ever being published.
+			inline bool commit()
+			{
+				assert(m_vector != nullptr && m_constructed == m_size);
+
+				concurrent_stack_vector* vector = m_vector;
+				m_vector = nullptr;
+				if (vector->_publish(m_begin, m_size))
+					return true;
+
+				vector->_destroy(m_begin, m_begin + m_constructed);
+				return false;
+			}
+
+		private:
+			friend class concurrent_stack_vector;
+
+			inline batch(concurrent_stack_vector* vector, size_t begin, size_t size) noexcept
+				: m_vector(vector), m_begin(begin), m_size(size), m_constructed(0) {}
+
+			inline void _abandon() noexcept
+			{
+				m_vector->_destroy(m_begin, m_begin + m_constructed);
+				m_vector->_seal(m_begin);
+				m_vector = nullptr;
+			}
+
+			concurrent_stack_vector* m_vector; // Null once committed, or when nothing was reserved.
+			size_t m_begin; // First slot reserved.
+			size_t m_size; // Number of slots reserved.
+			size_t m_constructed; // Slots constructed so far.
+		};
+
+		/* Allocation / Deallocation */
+	public:
+		concurrent_stack_vector() = default;
+
+		inline ~concurrent_stack_vector()
+		{
+			this->_destroy_ready();
+		}
+
+		concurrent_stack_vector(const concurrent_stack_vector&) = delete;
+		concurrent_stack_vector& operator=(const concurrent_stack_vector&) = delete;
+
+		/*----------------------------------------------------------*/
+		/*						  Appending							*/
+		/*----------------------------------------------------------*/
+
+		// Reserve count slots to fill with the batch's emplace_back, with a single atomic operation.
+		_NODISCARD inline batch reserve_n(size_t count) noexcept
+		{
+			const size_t begin = this->_reserve(count);
+			return batch(begin != npos ? this : nullptr, begin, count);
+		}
+
+		// Append a copy of the count elements at src as one batch, false if they don't fit.
+		inline bool append(const T* src, size_t count)
+		{
+			batch slots = this->reserve_n(count);
+			if (!slots)
+				return false;
+
+			for (size_t i = 0; i < count; i++)
+				slots.emplace_back(src[i]);
+			return slots.commit();
+		}
+
+		// Construct an element at the end, false if the vector is full.
+		template<typename... Args>
+		inline bool emplace_back(Args&&... args)
+		{
+			batch slot = this->reserve_n(1);
+			if (!slot)
+				return false;
+
+			slot.emplace_back(std::forward<Args>(args)...);
+			return slot.commit();
+		}
+
+		inline bool push_back(const T& value) { return this->emplace_back(value); }
+		inline bool push_back(T&& value) { return this->emplace_back(std::move(value)); }
+
+		// Destroy every element and start over, not safe while other threads append.
+		inline void clear() noexcept
+		{
+			this->_destroy_ready();
+			m_committed.store(0, std::memory_order_relaxed);
+			m_reserved.store(0, std::memory_order_relaxed);
+			m_limit.store(N, std::memory_order_release);
+		}
+
+		/*----------------------------------------------------------*/
+		/*						Element access						*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline const T& operator[](const size_t index) const noexcept
+		{
+			assert(index < this->size());
+			return this->_inline_data()[index];
+		}
+
+		_NODISCARD inline const T* data() const noexcept { return this->_inline_data(); }
+
+		// Published elements, as of now.
+		_NODISCARD inline span<const T> view() const noexcept { return span<const T>(this->_inline_data(), this->size()); }
+
+		/*----------------------------------------------------------*/
+		/*						Iterators							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline const_iterator begin() const noexcept { return this->_inline_data(); }
+		_NODISCARD inline const_iterator end() const noexcept { return this->_inline_data() + this->size(); }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity							*/
+		/*----------------------------------------------------------*/
+
+		// Number of published elements, every one of them fully constructed.
+		_NODISCARD inline size_t size() const noexcept { return m_committed.load(std::memory_order_acquire); }
+		_NODISCARD inline bool empty() const noexcept { return this->size() == 0; }
+		_NODISCARD static constexpr size_t capacity() noexcept { return N; }
+
+		/* Helper Functions */
+	private:
+		static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+		inline T* _slot(size_t index) noexcept { return this->_inline_data() + index; }
+
+		// First of count slots reserved for the caller, or npos if they go past the limit.
+		inline size_t _reserve(size_t count) noexcept
+		{
+			// Once full, fail without touching the counter any further.
+			const size_t limit = m_limit.load(std::memory_order_acquire);
+			if (count > limit || m_reserved.load(std::memory_order_relaxed) > limit - count)
+				return npos;
+
+			const size_t begin = m_reserved.fetch_add(count, std::memory_order_relaxed);
+			const size_t current = m_limit.load(std::memory_order_acquire);
+			if (count > current || begin > current - count)
+				return npos;
+
+			return begin;
+		}
+
+		// Mark [begin, begin + count) ready and publish whatever is ready from the current end on.
+		// False if an earlier append was abandoned, so this one can never be published.
+		inline bool _publish(size_t begin, size_t count) noexcept
+		{
+			if (begin >= m_limit.load(std::memory_order_acquire))
+				return false;
+
+			for (size_t i = begin; i < begin + count; i++)
+				m_ready[i].store(true, std::memory_order_seq_cst);
+			this->_drain();
+			return true;
+		}
+
+		// Move m_committed past every ready slot it reaches. Whoever marks a slot then reads
+		// m_committed, whoever moves m_committed then reads the next flag, and with both sides
+		// sequentially consistent at least one of them sees the other, so no ready run is stranded.
+		// An abandoned batch never marks its slots, so nothing gets past it.
+		inline void _drain() noexcept
+		{
+			size_t committed = m_committed.load(std::memory_order_seq_cst);
+			for (;;) {
+				size_t end = committed;
+				while (end < N && m_ready[end].load(std::memory_order_seq_cst))
+					end++;
+				if (end == committed)
+					return;
+
+				// On failure committed is reloaded, another thread got further, so scan from there.
+				if (m_committed.compare_exchange_weak(committed, end, std::memory_order_seq_cst))
+					committed = end;
+			}
+		}
+
+		// Nothing from index on can be published any more, lower the limit to it.
+		inline void _seal(size_t index) noexcept
+		{
+			size_t limit = m_limit.load(std::memory_order_relaxed);
+			while (index < limit && !m_limit.compare_exchange_weak(limit, index, std::memory_order_acq_rel)) {}
+		}
+
+		inline void _destroy(size_t begin, size_t end) noexcept
+		{
+			for (size_t i = begin; i < end; i++)
+				this->_slot(i)->~T();
+		}
+
+		// Destroy every committed element, published or still waiting on an abandoned append, and
+		// clear the ready flags. Not safe while other threads append.
+		inline void _destroy_ready() noexcept
+		{
+			const size_t reserved = m_reserved.load(std::memory_order_relaxed);
+			const size_t end = reserved < N ? reserved : N;
+			for (size_t i = 0; i < end; i++) {
+				if (m_ready[i].load(std::memory_order_acquire)) {
+					this->_slot(i)->~T();
+					m_ready[i].store(false, std::memory_order_relaxed);
+				}
+			}
+		}
+
+		/* Members */
+	private:
+		alignas(SAD_CACHE_LINE) std::atomic<size_t> m_reserved{ 0 }; // Slots handed out so far, may run past N.
+		alignas(SAD_CACHE_LINE) std::atomic<size_t> m_committed{ 0 }; // Elements published so far.
+		std::atomic<size_t> m_limit{ N }; // Slots that can still be published, N until an append is abandoned.
+		std::atomic<bool> m_ready[N]{}; // Set once the slot's batch is committed, published or not.
+
+	}; // !concurrent_stack_vector<T, N> class
+
+} // !namespace sad
+#endif
@@ -0,0 +1,20 @@
+#ifndef SAD_CONFIG_H
+#define SAD_CONFIG_H
+
+#include <type_traits>
+
+// From C++20 on, stack_vector can be used in constant expressions for trivial element types, so
+// lookup tables can be built by constexpr functions and end up in read-only data. Only the
+// inline-only mode (N > 0, no Allocator) can outlive the constant evaluation that built it.
+// SAD_CONSTEXPR marks everything that takes part, and is empty before C++20.
+#if (__cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)) && defined(__cpp_constexpr_dynamic_alloc)
+	#define SAD_CONSTEXPR_VECTOR 1
+	#define SAD_CONSTEXPR constexpr
+	#define SAD_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+	#define SAD_CONSTEXPR_VECTOR 0
+	#define SAD_CONSTEXPR
+	#define SAD_IS_CONSTANT_EVALUATED() false
+#endif
+
+#endif
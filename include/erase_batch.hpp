@@ -0,0 +1,99 @@
+#ifndef ERASE_BATCH_H
+#define ERASE_BATCH_H
+
+#include <cassert>
+#include <cstddef>
+
+#include "stack_vector.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	template<typename Vector>
+	class erase_batch;
+
+	// Tombstones for a stack_vector: erase() only marks an element, and flush() (or the destructor)
+	// removes every marked element in one order-keeping compaction pass, instead of shifting the
+	// tail once per erase. The marks are a stack_vector<bool> with the vector's inline size, and
+	// its allocator for when they outgrow that.
+	// Indices refer to the vector as it is before the flush, so don't insert into or erase from
+	// the middle of the vector while marks are pending; appending is fine.
+	//     sad::erase_batch<decltype(particles)> dead(particles);
+	//     for (size_t i = 0; i < particles.size(); i++)
+	//         if (particles[i].expired()) dead.erase(i);
+	//     dead.flush();
+	template<typename T, std::size_t N, typename Allocator, typename Growth>
+	class erase_batch<stack_vector<T, N, Allocator, Growth>>
+	{
+	public:
+		using vector_type = stack_vector<T, N, Allocator, Growth>;
+
+		/* Allocation / Deallocation */
+	public:
+		inline explicit erase_batch(vector_type& vector)
+			: m_vector(vector), m_marks(typename marks_type::allocator_type(vector.get_allocator())) {}
+
+		// Flushes whatever is still marked.
+		inline ~erase_batch() noexcept
+		{
+			this->flush();
+		}
+
+		erase_batch(const erase_batch&) = delete;
+		erase_batch& operator=(const erase_batch&) = delete;
+
+		/*----------------------------------------------------------*/
+		/*						  Modifiers						    */
+		/*----------------------------------------------------------*/
+
+		// Mark the element at index for erasing. Marking it again does nothing.
+		inline void erase(const size_t index)
+		{
+			assert(index < m_vector.size());
+			if (index >= m_marks.size())
+				m_marks.resize(m_vector.size());
+
+			if (!m_marks[index]) {
+				m_marks[index] = true;
+				m_pending++;
+			}
+		}
+
+		// Erase every marked element, keeping the order of the rest. Returns how many were erased.
+		// Never throws: elements appended since the marks last grew are past them, and simply kept.
+		inline size_t flush() noexcept
+		{
+			if (m_pending == 0)
+				return 0;
+
+			const size_t erased = m_vector.erase_marked(m_marks.word_data(), m_marks.word_count());
+			m_marks.clear();
+			m_pending = 0;
+			return erased;
+		}
+
+		/*----------------------------------------------------------*/
+		/*						    Lookup							*/
+		/*----------------------------------------------------------*/
+
+		// Check if the element at index is marked.
+		_NODISCARD inline bool erased(const size_t index) const noexcept
+		{
+			return index < m_marks.size() && m_marks[index];
+		}
+
+		// Number of elements marked since the last flush.
+		_NODISCARD inline size_t pending() const noexcept { return m_pending; }
+
+		/* Members */
+	private:
+		using marks_type = stack_vector<bool, N, Allocator, Growth>;
+
+		vector_type& m_vector;
+		marks_type m_marks; // One bit per element, set when marked.
+		size_t m_pending = 0; // Marked elements.
+
+	}; // !erase_batch<stack_vector<T, N, Allocator, Growth>> class
+
+} // !namespace sad
+#endif
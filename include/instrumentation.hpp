@@ -0,0 +1,298 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+// Define SAD_INSTRUMENTATION as 1 (the same way in every translation unit, before any sad header)
+// to count what the stack_vectors of a program do: reallocations, elements moved and copied,
+// peak capacity and peak stack bytes (inline bytes holding elements), per vector type and per
+// call site marked with SAD_INSTRUMENT. Off by default, in which case none of it is compiled in.
+#ifndef SAD_INSTRUMENTATION
+	#define SAD_INSTRUMENTATION 0
+#endif
+
+#include <cstddef>
+
+#include "config.hpp"
+
+#if SAD_INSTRUMENTATION
+	#include <atomic>
+	#include <cstdio>
+	#include <mutex>
+	#include <string>
+	#include <vector>
+#endif
+
+// Stack Allocated Data
+namespace sad {
+
+	namespace instrumentation {
+
+		class stats;
+
+	} // !namespace instrumentation
+
+#if SAD_INSTRUMENTATION
+
+	namespace instrumentation {
+
+		// Every stats object alive, so they can all be dumped at once.
+		class registry
+		{
+		public:
+			static inline registry& instance()
+			{
+				static registry global;
+				return global;
+			}
+
+			inline void add(stats* entry)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_entries.push_back(entry);
+			}
+
+			inline void remove(stats* entry)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				for (size_t i = 0; i < m_entries.size(); ++i) {
+					if (m_entries[i] == entry) {
+						m_entries.erase(m_entries.begin() + i);
+						return;
+					}
+				}
+			}
+
+			// Copy of the list of entries, in order of registration.
+			inline std::vector<stats*> snapshot() const
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				return m_entries;
+			}
+
+		private:
+			mutable std::mutex m_mutex;
+			std::vector<stats*> m_entries;
+
+		}; // !registry class
+
+
+		// Counters of one vector type or one call site, updated with relaxed atomics so vectors on
+		// any thread can share them.
+		class stats
+		{
+		public:
+			inline stats(const char* kind, std::string name) : m_kind(kind), m_name(std::move(name))
+			{
+				registry::instance().add(this);
+			}
+
+			inline ~stats()
+			{
+				registry::instance().remove(this);
+			}
+
+			stats(const stats&) = delete;
+			stats& operator=(const stats&) = delete;
+
+			// "type" or "site".
+			inline const char* kind() const noexcept { return m_kind; }
+
+			// Vector type, or file:line of the call site.
+			inline const std::string& name() const noexcept { return m_name; }
+
+			inline size_t instances() const noexcept { return m_instances.load(std::memory_order_relaxed); }
+			inline size_t reallocations() const noexcept { return m_reallocations.load(std::memory_order_relaxed); }
+			inline size_t moved() const noexcept { return m_moved.load(std::memory_order_relaxed); }
+			inline size_t copied() const noexcept { return m_copied.load(std::memory_order_relaxed); }
+			inline size_t peak_capacity() const noexcept { return m_peak_capacity.load(std::memory_order_relaxed); }
+			inline size_t peak_stack_bytes() const noexcept { return m_peak_stack_bytes.load(std::memory_order_relaxed); }
+
+			inline void add_instance() noexcept { m_instances.fetch_add(1, std::memory_order_relaxed); }
+			inline void add_reallocation() noexcept { m_reallocations.fetch_add(1, std::memory_order_relaxed); }
+			inline void add_moved(size_t count) noexcept { m_moved.fetch_add(count, std::memory_order_relaxed); }
+			inline void add_copied(size_t count) noexcept { m_copied.fetch_add(count, std::memory_order_relaxed); }
+			inline void raise_capacity(size_t capacity) noexcept { _raise(m_peak_capacity, capacity); }
+			inline void raise_stack_bytes(size_t bytes) noexcept { _raise(m_peak_stack_bytes, bytes); }
+
+			inline void reset() noexcept
+			{
+				m_instances.store(0, std::memory_order_relaxed);
+				m_reallocations.store(0, std::memory_order_relaxed);
+				m_moved.store(0, std::memory_order_relaxed);
+				m_copied.store(0, std::memory_order_relaxed);
+				m_peak_capacity.store(0, std::memory_order_relaxed);
+				m_peak_stack_bytes.store(0, std::memory_order_relaxed);
+			}
+
+		private:
+			static inline void _raise(std::atomic<size_t>& peak, size_t value) noexcept
+			{
+				size_t current = peak.load(std::memory_order_relaxed);
+				while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+			}
+
+			const char* m_kind;
+			std::string m_name;
+			std::atomic<size_t> m_instances{ 0 };
+			std::atomic<size_t> m_reallocations{ 0 };
+			std::atomic<size_t> m_moved{ 0 };
+			std::atomic<size_t> m_copied{ 0 };
+			std::atomic<size_t> m_peak_capacity{ 0 };
+			std::atomic<size_t> m_peak_stack_bytes{ 0 };
+
+		}; // !stats class
+
+
+		// Print every counter, one line per type and call site.
+		inline void dump(std::FILE* out = stderr)
+		{
+			std::fprintf(out, "%-5s %10s %10s %12s %12s %10s %12s  %s\n", "kind", "instances", "reallocs", "moved", "copied", "peak_cap", "peak_stack", "name");
+			for (const stats* entry : registry::instance().snapshot()) {
+				std::fprintf(out, "%-5s %10zu %10zu %12zu %12zu %10zu %12zu  %s\n", entry->kind(), entry->instances(), entry->reallocations(),
+					entry->moved(), entry->copied(), entry->peak_capacity(), entry->peak_stack_bytes(), entry->name().c_str());
+			}
+		}
+
+		// Zero every counter.
+		inline void reset()
+		{
+			for (stats* entry : registry::instance().snapshot())
+				entry->reset();
+		}
+
+		namespace detail {
+
+			// Readable name of T, taken from the compiler's signature of this function.
+			template<typename T>
+			inline std::string type_name()
+			{
+			#if defined(__clang__) || defined(__GNUC__)
+				const std::string signature = __PRETTY_FUNCTION__; // "... [with T = X; ...]" or "... [T = X]"
+				const size_t start = signature.find("T = ") + 4;
+				return signature.substr(start, signature.find_first_of(";]", start) - start);
+			#elif defined(_MSC_VER)
+				const std::string signature = __FUNCSIG__; // "... type_name<X>(void)"
+				const size_t start = signature.find("type_name<") + 10;
+				return signature.substr(start, signature.rfind(">(void)") - start);
+			#else
+				return "unknown";
+			#endif
+			}
+
+			// Counters shared by every vector of type Vector.
+			template<typename Vector>
+			inline stats& type_stats()
+			{
+				static stats type("type", type_name<Vector>());
+				return type;
+			}
+
+			inline std::string site_name(const char* file, int line)
+			{
+				return std::string(file) + ":" + std::to_string(line);
+			}
+
+		} // !namespace detail
+
+	} // !namespace instrumentation
+
+	// Count what vec does from here on under the line this is written on, as well as under its type.
+	#define SAD_INSTRUMENT(vec) ((vec).instrument([]() -> sad::instrumentation::stats& { static sad::instrumentation::stats site("site", sad::instrumentation::detail::site_name(__FILE__, __LINE__)); return site; }()))
+
+	namespace detail {
+
+		// Feeds the counters of its vector's type and, once attached, of a call site.
+		template<typename Vector>
+		class instrument_holder
+		{
+		public:
+			inline void instrument(instrumentation::stats& site) noexcept
+			{
+				m_site = &site;
+				site.add_instance();
+				site.raise_stack_bytes(m_peak_stack_bytes);
+			}
+
+		protected:
+			inline instrument_holder() noexcept { this->_instrument_instance(); }
+			inline instrument_holder(const instrument_holder&) noexcept : instrument_holder() {}
+			inline instrument_holder& operator=(const instrument_holder&) noexcept { return *this; } // Each vector keeps its own site.
+
+			// Buffer moved or grew. The first buffer of a new vector (no capacity yet) only counts towards
+			// the peak capacity, inline buffers included.
+			inline void _instrument_reallocate(const void* old_data, size_t old_capacity, const void* new_data, size_t new_capacity) noexcept
+			{
+				const bool reallocated = old_capacity != 0 && (old_data != new_data || old_capacity != new_capacity);
+				this->_each([reallocated, new_capacity](instrumentation::stats& s) {
+					if (reallocated)
+						s.add_reallocation();
+					s.raise_capacity(new_capacity);
+				});
+			}
+
+			inline void _instrument_moved(size_t count) noexcept
+			{
+				if (count > 0)
+					this->_each([count](instrumentation::stats& s) { s.add_moved(count); });
+			}
+
+			inline void _instrument_copied(size_t count) noexcept
+			{
+				if (count > 0)
+					this->_each([count](instrumentation::stats& s) { s.add_copied(count); });
+			}
+
+			// Bytes of the inline buffer holding elements, only shared with the counters when this
+			// vector's own peak rises.
+			inline void _instrument_stack_bytes(size_t bytes) noexcept
+			{
+				if (bytes > m_peak_stack_bytes) {
+					m_peak_stack_bytes = bytes;
+					this->_each([bytes](instrumentation::stats& s) { s.raise_stack_bytes(bytes); });
+				}
+			}
+
+		private:
+			template<typename F>
+			inline void _each(F f) noexcept
+			{
+				f(instrumentation::detail::type_stats<Vector>());
+				if (m_site)
+					f(*m_site);
+			}
+
+			inline void _instrument_instance() noexcept
+			{
+				instrumentation::detail::type_stats<Vector>().add_instance();
+			}
+
+			instrumentation::stats* m_site = nullptr; // Call site attached with SAD_INSTRUMENT.
+			size_t m_peak_stack_bytes = 0; // Most inline bytes this vector has had in use.
+		};
+
+	} // !namespace detail
+
+#else
+
+	#define SAD_INSTRUMENT(vec) ((void)(vec))
+
+	namespace detail {
+
+		// Instrumentation is off, every hook compiles to nothing.
+		template<typename Vector>
+		struct instrument_holder
+		{
+			SAD_CONSTEXPR inline void instrument(instrumentation::stats&) noexcept {}
+
+		protected:
+			SAD_CONSTEXPR inline void _instrument_reallocate(const void*, size_t, const void*, size_t) noexcept {}
+			SAD_CONSTEXPR inline void _instrument_moved(size_t) noexcept {}
+			SAD_CONSTEXPR inline void _instrument_copied(size_t) noexcept {}
+			SAD_CONSTEXPR inline void _instrument_stack_bytes(size_t) noexcept {}
+		};
+
+	} // !namespace detail
+
+#endif
+
+} // !namespace sad
+#endif
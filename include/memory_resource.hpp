@@ -0,0 +1,192 @@
+#ifndef MEMORY_RESOURCE_H
+#define MEMORY_RESOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#include "stack_vector.hpp"
+#include "stack_arena.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	// Polymorphic source of memory, modelled on std::pmr::memory_resource (which needs C++17).
+	// Lets the storage strategy of a vector be picked at run time without changing its type.
+	class memory_resource
+	{
+	public:
+		virtual ~memory_resource() = default;
+
+		_NODISCARD inline void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+		{
+			return this->do_allocate(bytes, alignment);
+		}
+
+		inline void deallocate(void* ptr, size_t bytes, size_t alignment = alignof(std::max_align_t))
+		{
+			this->do_deallocate(ptr, bytes, alignment);
+		}
+
+		// Grow the block at ptr to new_bytes without moving it, if the resource can.
+		inline bool try_extend(void* ptr, size_t old_bytes, size_t new_bytes)
+		{
+			return this->do_try_extend(ptr, old_bytes, new_bytes);
+		}
+
+		inline bool is_equal(const memory_resource& other) const noexcept
+		{
+			return this->do_is_equal(other);
+		}
+
+	protected:
+		virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+		virtual void do_deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+		virtual bool do_try_extend(void*, size_t, size_t) { return false; }
+		virtual bool do_is_equal(const memory_resource& other) const noexcept { return this == &other; }
+
+	}; // !memory_resource class
+
+	inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept
+	{
+		return &lhs == &rhs || lhs.is_equal(rhs);
+	}
+
+	inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+
+	// Resource using the global operator new and delete. operator new only takes an alignment from
+	// C++17 on, so a block aligned past std::max_align_t is cut out of a bigger one, with the
+	// address of that one kept just before it.
+	class new_delete_resource_type final : public memory_resource
+	{
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			if (alignment <= alignof(std::max_align_t))
+				return ::operator new(bytes);
+
+			const size_t padding = alignment - 1 + sizeof(void*);
+			if (bytes > std::numeric_limits<size_t>::max() - padding)
+				detail::throw_bad_alloc();
+
+			void* block = ::operator new(bytes + padding);
+			const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(block) + sizeof(void*);
+			void** aligned = reinterpret_cast<void**>((first + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1));
+			aligned[-1] = block;
+			return aligned;
+		}
+
+		void do_deallocate(void* ptr, size_t, size_t alignment) override
+		{
+			if (alignment > alignof(std::max_align_t))
+				ptr = static_cast<void**>(ptr)[-1];
+			::operator delete(ptr);
+		}
+		bool do_is_equal(const memory_resource& other) const noexcept override
+		{
+			return dynamic_cast<const new_delete_resource_type*>(&other) != nullptr;
+		}
+
+	}; // !new_delete_resource_type class
+
+	// Shared heap resource.
+	inline memory_resource* new_delete_resource() noexcept
+	{
+		static new_delete_resource_type resource;
+		return &resource;
+	}
+
+
+	// Resource handing out memory from a stack_arena, growing its last block in place.
+	class arena_resource final : public memory_resource
+	{
+	public:
+		inline explicit arena_resource(stack_arena& arena) noexcept : m_arena(arena) {}
+
+		_NODISCARD inline stack_arena& arena() const noexcept { return m_arena; }
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override { return m_arena.allocate(bytes, alignment); }
+		void do_deallocate(void* ptr, size_t bytes, size_t) override { m_arena.deallocate(ptr, bytes); }
+		bool do_try_extend(void* ptr, size_t old_bytes, size_t new_bytes) override { return m_arena.try_extend(ptr, old_bytes, new_bytes); }
+
+	private:
+		stack_arena& m_arena;
+
+	}; // !arena_resource class
+
+
+	// Allocator forwarding to a memory_resource, modelled on std::pmr::polymorphic_allocator.
+	template<typename T>
+	class polymorphic_allocator
+	{
+	public:
+		using value_type = T;
+
+		template<typename U>
+		struct rebind { using other = polymorphic_allocator<U>; };
+
+	public:
+		inline polymorphic_allocator() noexcept : m_resource(new_delete_resource()) {}
+		inline polymorphic_allocator(memory_resource* resource) noexcept : m_resource(resource) {}
+
+		template<typename U>
+		inline polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept : m_resource(other.resource()) {}
+
+		_NODISCARD inline T* allocate(size_t n)
+		{
+			if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+				detail::throw_bad_alloc();
+
+			return static_cast<T*>(m_resource->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		inline void deallocate(T* ptr, size_t n) noexcept
+		{
+			m_resource->deallocate(ptr, n * sizeof(T), alignof(T));
+		}
+
+		// Grow the block at ptr from old_n to new_n elements without moving it.
+		inline bool try_extend(T* ptr, size_t old_n, size_t new_n)
+		{
+			if (new_n > std::numeric_limits<size_t>::max() / sizeof(T))
+				return false;
+
+			return m_resource->try_extend(ptr, old_n * sizeof(T), new_n * sizeof(T));
+		}
+
+		// Copies of a container start out on the default resource, like std::pmr.
+		_NODISCARD inline polymorphic_allocator select_on_container_copy_construction() const noexcept
+		{
+			return polymorphic_allocator();
+		}
+
+		_NODISCARD inline memory_resource* resource() const noexcept { return m_resource; }
+
+		template<typename U>
+		inline bool operator==(const polymorphic_allocator<U>& rhs) const noexcept { return *m_resource == *rhs.resource(); }
+
+		template<typename U>
+		inline bool operator!=(const polymorphic_allocator<U>& rhs) const noexcept { return !(*this == rhs); }
+
+	private:
+		memory_resource* m_resource;
+
+	}; // !polymorphic_allocator<T> class
+
+
+	namespace pmr {
+
+		// stack_vector whose storage beyond its N inline elements is chosen at run time.
+		template<typename T, std::size_t N = 0, typename Growth = growth::geometric>
+		using stack_vector = sad::stack_vector<T, N, polymorphic_allocator<T>, Growth>;
+
+	} // !namespace pmr
+
+} // !namespace sad
+#endif
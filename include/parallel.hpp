@@ -0,0 +1,561 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "span.hpp"
+#include "stack_vector.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	// Data parallel loops over contiguous ranges (stack_vector, span, std::vector...) on a small
+	// work-stealing thread pool.
+	namespace parallel {
+
+		namespace detail {
+
+			// Chunks smaller than this cost more to hand out than to run.
+			constexpr size_t min_chunk_bytes = 4096;
+
+			// Chunks handed to each worker up front, the rest of the balancing is done by stealing.
+			constexpr size_t chunks_per_worker = 4;
+
+			// Index of the worker the calling thread is, 0 for any thread outside a pool.
+			inline size_t& current_worker() noexcept
+			{
+				static thread_local size_t worker = 0;
+				return worker;
+			}
+
+			// Pool whose job the calling thread is running, if any.
+			inline const void*& current_pool() noexcept
+			{
+				static thread_local const void* pool = nullptr;
+				return pool;
+			}
+
+			// Makes the calling thread a worker of pool until the end of the scope.
+			struct worker_scope
+			{
+				const void* m_outer_pool;
+				size_t m_outer_worker;
+
+				inline worker_scope(const void* pool, size_t worker) noexcept : m_outer_pool(current_pool()), m_outer_worker(current_worker())
+				{
+					current_pool() = pool;
+					current_worker() = worker;
+				}
+
+				inline ~worker_scope()
+				{
+					current_pool() = m_outer_pool;
+					current_worker() = m_outer_worker;
+				}
+			};
+
+			// Chunks still to be run by one worker. The owner takes them from the front, an idle
+			// worker steals the back half.
+			struct alignas(SAD_CACHE_LINE) chunk_queue
+			{
+				std::mutex m_mutex;
+				size_t m_begin = 0;
+				size_t m_end = 0;
+
+				inline void assign(size_t begin, size_t end)
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_begin = begin;
+					m_end = end;
+				}
+
+				inline bool pop(size_t& chunk)
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					if (m_begin == m_end)
+						return false;
+
+					chunk = m_begin++;
+					return true;
+				}
+
+				// Take the back half (at least one chunk) as [begin, end).
+				inline bool steal(size_t& begin, size_t& end)
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					if (m_begin == m_end)
+						return false;
+
+					begin = m_begin + (m_end - m_begin) / 2;
+					end = m_end;
+					m_end = begin;
+					return true;
+				}
+			};
+
+			// Split count elements at data into chunks whose bytes are whole cache lines. The first one
+			// also takes the elements before data's first line boundary, making it the longest, so that
+			// every later chunk starts on a line boundary when data allows it.
+			template<typename T>
+			class chunking
+			{
+			public:
+				inline chunking(const T* data, size_t count, size_t workers) noexcept : m_count(count)
+				{
+					const size_t line = SAD_CACHE_LINE;
+					const size_t per_line = line / _gcd(sizeof(T), line);
+
+					const size_t misalignment = reinterpret_cast<std::uintptr_t>(data) % line;
+					const size_t to_boundary = (line - misalignment) % line;
+					m_offset = (to_boundary % sizeof(T) == 0) ? std::min(to_boundary / sizeof(T), count) : 0;
+
+					const size_t target = std::max<size_t>(workers * chunks_per_worker, 1);
+					const size_t min_size = std::max<size_t>(min_chunk_bytes / sizeof(T), 1);
+					m_size = std::max((count + target - 1) / target, min_size);
+					m_size = (m_size + per_line - 1) / per_line * per_line;
+
+					m_chunks = (count <= m_offset) ? (count > 0 ? 1 : 0) : 1 + (count - m_offset - 1) / m_size;
+				}
+
+				_NODISCARD inline size_t chunks() const noexcept { return m_chunks; }
+				_NODISCARD inline size_t begin(size_t chunk) const noexcept { return chunk == 0 ? 0 : std::min(m_offset + chunk * m_size, m_count); }
+				_NODISCARD inline size_t end(size_t chunk) const noexcept { return std::min(m_offset + (chunk + 1) * m_size, m_count); }
+
+			private:
+				static inline size_t _gcd(size_t a, size_t b) noexcept
+				{
+					while (b != 0) {
+						const size_t r = a % b;
+						a = b;
+						b = r;
+					}
+					return a;
+				}
+
+				size_t m_count; // Elements split.
+				size_t m_offset = 0; // Elements before the first line boundary.
+				size_t m_size = 1; // Elements per chunk after the first.
+				size_t m_chunks = 0; // Number of chunks.
+			};
+
+		} // !namespace detail
+
+
+		// Fixed set of worker threads running one chunked job at a time, with the calling thread
+		// joining in as worker 0. Every worker starts with an even share of the chunks and steals
+		// from the others once it runs out, so uneven chunks still finish together.
+		class thread_pool
+		{
+		public:
+			// Pool of threads workers in total, the calling thread of run() included.
+			inline explicit thread_pool(size_t threads = std::thread::hardware_concurrency())
+				: m_queues(std::max<size_t>(threads, 1))
+			{
+				m_threads.reserve(m_queues.size() - 1);
+				for (size_t i = 1; i < m_queues.size(); i++)
+					m_threads.emplace_back(&thread_pool::_work, this, i);
+			}
+
+			inline ~thread_pool()
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_stop = true;
+				}
+				m_wake.notify_all();
+
+				for (std::thread& thread : m_threads)
+					thread.join();
+			}
+
+			thread_pool(const thread_pool&) = delete;
+			thread_pool& operator=(const thread_pool&) = delete;
+
+			// Number of workers, the calling thread included.
+			_NODISCARD inline size_t size() const noexcept { return m_queues.size(); }
+
+			// Call f(chunk, worker) for every chunk in [0, chunks) and return once all of them ran.
+			// The first exception thrown by f is rethrown here, the chunks not yet started are skipped.
+			// Calls from inside a job of the same pool run every chunk on the calling worker.
+			template<typename F>
+			inline void run(size_t chunks, F&& f)
+			{
+				if (chunks == 0)
+					return;
+
+				if (detail::current_pool() == this) {
+					const size_t worker = detail::current_worker();
+					for (size_t chunk = 0; chunk < chunks; chunk++)
+						f(chunk, worker);
+					return;
+				}
+
+				// Any other caller is worker 0, so it waits for the job using that worker to finish,
+				// even when it runs every chunk itself.
+				std::lock_guard<std::mutex> serial(m_run_mutex);
+
+				if (chunks == 1 || m_queues.size() == 1) {
+					detail::worker_scope scope(this, 0);
+					for (size_t chunk = 0; chunk < chunks; chunk++)
+						f(chunk, 0);
+					return;
+				}
+
+				const size_t workers = m_queues.size();
+				for (size_t i = 0; i < workers; i++)
+					m_queues[i].assign(chunks * i / workers, chunks * (i + 1) / workers);
+
+				using body = typename std::remove_reference<F>::type;
+				m_exception = nullptr;
+				m_failed.store(false, std::memory_order_relaxed);
+				m_finished.store(0, std::memory_order_relaxed);
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_job = &thread_pool::_invoke<body>;
+					m_context = const_cast<void*>(static_cast<const void*>(&f));
+					m_chunks = chunks;
+					m_open = true;
+					m_generation++;
+				}
+				m_wake.notify_all();
+
+				this->_drain(0, m_job, m_context);
+
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_done.wait(lock, [this, chunks]() { return m_finished.load(std::memory_order_acquire) == chunks && m_active == 0; });
+					m_open = false;
+				}
+
+				if (m_exception) {
+					std::exception_ptr exception = m_exception;
+					m_exception = nullptr;
+					std::rethrow_exception(exception);
+				}
+			}
+
+			/* Helper Functions */
+		private:
+			using job = void(*)(void*, size_t, size_t);
+
+			template<typename F>
+			static inline void _invoke(void* context, size_t chunk, size_t worker)
+			{
+				(*static_cast<F*>(context))(chunk, worker);
+			}
+
+			// Worker thread, sleeping until a job is opened.
+			inline void _work(size_t worker)
+			{
+				detail::current_worker() = worker;
+				size_t seen = 0;
+
+				for (;;) {
+					job body;
+					void* context;
+					{
+						std::unique_lock<std::mutex> lock(m_mutex);
+						m_wake.wait(lock, [this, seen]() { return m_stop || (m_open && m_generation != seen); });
+						if (m_stop)
+							return;
+
+						seen = m_generation;
+						body = m_job;
+						context = m_context;
+						m_active++;
+					}
+
+					this->_drain(worker, body, context);
+
+					{
+						std::lock_guard<std::mutex> lock(m_mutex);
+						m_active--;
+					}
+					m_done.notify_all();
+				}
+			}
+
+			// Run chunks from the worker's own queue, then steal until every queue is empty.
+			inline void _drain(size_t worker, job body, void* context)
+			{
+				detail::worker_scope scope(this, worker);
+
+				size_t chunk;
+				for (;;) {
+					if (m_queues[worker].pop(chunk)) {
+						this->_run_chunk(body, context, chunk, worker);
+						continue;
+					}
+
+					bool stolen = false;
+					const size_t workers = m_queues.size();
+					for (size_t i = 1; i < workers && !stolen; i++) {
+						size_t begin, end;
+						if (m_queues[(worker + i) % workers].steal(begin, end)) {
+							m_queues[worker].assign(begin + 1, end);
+							this->_run_chunk(body, context, begin, worker);
+							stolen = true;
+						}
+					}
+					if (!stolen)
+						break;
+				}
+			}
+
+			inline void _run_chunk(job body, void* context, size_t chunk, size_t worker)
+			{
+				if (!m_failed.load(std::memory_order_relaxed)) {
+					#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+						try {
+							body(context, chunk, worker);
+						}
+						catch (...) {
+							std::lock_guard<std::mutex> lock(m_mutex);
+							if (!m_failed.exchange(true, std::memory_order_relaxed))
+								m_exception = std::current_exception();
+						}
+					#else
+						body(context, chunk, worker);
+					#endif
+				}
+
+				if (m_finished.fetch_add(1, std::memory_order_acq_rel) + 1 == m_chunks) {
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_done.notify_all();
+				}
+			}
+
+			/* Members */
+		private:
+			std::vector<detail::chunk_queue> m_queues; // One per worker.
+			std::vector<std::thread> m_threads; // Workers 1 and up, worker 0 is the caller of run().
+
+			std::mutex m_run_mutex; // One job at a time.
+			std::mutex m_mutex; // Guards the job description and the counters below.
+			std::condition_variable m_wake; // A job was opened or the pool is stopping.
+			std::condition_variable m_done; // A chunk finished or a worker went idle.
+
+			job m_job = nullptr;
+			void* m_context = nullptr;
+			size_t m_chunks = 0;
+			size_t m_generation = 0; // Bumped for every job, so workers join each one once.
+			size_t m_active = 0; // Workers draining the current job.
+			bool m_open = false; // Workers may still join the current job.
+			bool m_stop = false;
+
+			std::atomic<size_t> m_finished{ 0 }; // Chunks run or skipped.
+			std::atomic<bool> m_failed{ false }; // A chunk threw, skip the rest.
+			std::exception_ptr m_exception;
+
+		}; // !thread_pool class
+
+
+		// Pool shared by the algorithms below when none is given, one worker per hardware thread.
+		inline thread_pool& default_pool()
+		{
+			static thread_pool pool;
+			return pool;
+		}
+
+		// Index of the worker running the calling code, in [0, pool.size()).
+		_NODISCARD inline size_t this_worker() noexcept { return detail::current_worker(); }
+
+
+		// One T per worker, each on its own cache lines, for scratch space and partial results that
+		// workers fill without synchronising, e.g. per_worker<stack_vector<hit, 256>> hits(pool);
+		template<typename T>
+		class per_worker
+		{
+		public:
+			inline explicit per_worker(const thread_pool& pool, const T& value = T()) : per_worker(pool.size(), value) {}
+
+			inline per_worker(size_t workers, const T& value = T()) : m_size(workers)
+			{
+				m_memory = ::operator new(m_size * stride + SAD_CACHE_LINE);
+				const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_memory);
+				m_data = reinterpret_cast<char*>((address + SAD_CACHE_LINE - 1) & ~static_cast<std::uintptr_t>(SAD_CACHE_LINE - 1));
+
+				size_t constructed = 0;
+				#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+					try {
+						for (; constructed < m_size; constructed++)
+							::new (static_cast<void*>(m_data + constructed * stride)) T(value);
+					}
+					catch (...) {
+						this->_destroy(constructed);
+						throw;
+					}
+				#else
+					for (; constructed < m_size; constructed++)
+						::new (static_cast<void*>(m_data + constructed * stride)) T(value);
+				#endif
+			}
+
+			inline ~per_worker() { this->_destroy(m_size); }
+
+			per_worker(const per_worker&) = delete;
+			per_worker& operator=(const per_worker&) = delete;
+
+			_NODISCARD inline T& operator[](const size_t worker) noexcept
+			{
+				assert(worker < m_size);
+				return *reinterpret_cast<T*>(m_data + worker * stride);
+			}
+
+			_NODISCARD inline const T& operator[](const size_t worker) const noexcept
+			{
+				assert(worker < m_size);
+				return *reinterpret_cast<const T*>(m_data + worker * stride);
+			}
+
+			// The calling worker's T.
+			_NODISCARD inline T& local() noexcept { return (*this)[this_worker()]; }
+
+			_NODISCARD inline size_t size() const noexcept { return m_size; }
+
+		private:
+			static constexpr size_t stride = (sizeof(T) + SAD_CACHE_LINE - 1) / SAD_CACHE_LINE * SAD_CACHE_LINE;
+
+			static_assert(alignof(T) <= SAD_CACHE_LINE, "sad::parallel::per_worker: T is aligned past a cache line");
+
+			inline void _destroy(size_t count) noexcept
+			{
+				for (size_t i = 0; i < count; i++)
+					reinterpret_cast<T*>(m_data + i * stride)->~T();
+				::operator delete(m_memory);
+			}
+
+			void* m_memory; // Block as allocated.
+			char* m_data; // First cache line boundary in m_memory.
+			size_t m_size; // Number of workers.
+
+		}; // !per_worker<T> class
+
+
+		/*----------------------------------------------------------*/
+		/*						  Algorithms						*/
+		/*----------------------------------------------------------*/
+
+		// Call f(chunk, worker) for cache line aligned chunks of the count elements at data, chunk
+		// being a sad::span of them and worker indexing any per_worker scratch.
+		template<typename T, typename F>
+		inline void for_each_chunk(thread_pool& pool, T* data, size_t count, F f)
+		{
+			const detail::chunking<T> chunks(data, count, pool.size());
+			pool.run(chunks.chunks(), [&](size_t chunk, size_t worker) {
+				const size_t begin = chunks.begin(chunk);
+				f(span<T>(data + begin, chunks.end(chunk) - begin), worker);
+			});
+		}
+
+		template<typename Range, typename F>
+		inline void for_each_chunk(thread_pool& pool, Range& range, F f)
+		{
+			parallel::for_each_chunk(pool, range.data(), range.size(), std::move(f));
+		}
+
+		template<typename Range, typename F>
+		inline void for_each_chunk(Range& range, F f)
+		{
+			parallel::for_each_chunk(default_pool(), range.data(), range.size(), std::move(f));
+		}
+
+		// Call f(element) for every element of range.
+		template<typename Range, typename F>
+		inline void for_each(thread_pool& pool, Range& range, F f)
+		{
+			using value_type = typename std::remove_pointer<decltype(range.data())>::type;
+			parallel::for_each_chunk(pool, range.data(), range.size(), [&f](span<value_type> chunk, size_t) {
+				for (value_type& element : chunk)
+					f(element);
+			});
+		}
+
+		template<typename Range, typename F>
+		inline void for_each(Range& range, F f)
+		{
+			parallel::for_each(default_pool(), range, std::move(f));
+		}
+
+		// out[i] = f(in[i]) for every element of in, out being at least as long.
+		// Chunks follow the lines of out, the side being written.
+		template<typename In, typename Out, typename F>
+		inline void transform(thread_pool& pool, const In& in, Out& out, F f)
+		{
+			assert(out.size() >= in.size());
+
+			const auto source = in.data();
+			const auto destination = out.data();
+			const detail::chunking<typename std::remove_pointer<decltype(out.data())>::type> chunks(destination, in.size(), pool.size());
+			pool.run(chunks.chunks(), [&](size_t chunk, size_t) {
+				const size_t end = chunks.end(chunk);
+				for (size_t i = chunks.begin(chunk); i < end; i++)
+					destination[i] = f(source[i]);
+			});
+		}
+
+		template<typename In, typename Out, typename F>
+		inline void transform(const In& in, Out& out, F f)
+		{
+			parallel::transform(default_pool(), in, out, std::move(f));
+		}
+
+		// init combined with transform(element) for every element of range, through reduce.
+		// reduce has to be associative, the partial results of the chunks are combined in order.
+		template<typename Range, typename T, typename Reduce, typename Transform>
+		inline T transform_reduce(thread_pool& pool, const Range& range, T init, Reduce reduce, Transform transform)
+		{
+			const auto data = range.data();
+			const detail::chunking<typename std::remove_pointer<decltype(range.data())>::type> chunks(data, range.size(), pool.size());
+
+			stack_vector<T> partials;
+			partials.resize(chunks.chunks(), init);
+			pool.run(chunks.chunks(), [&](size_t chunk, size_t) {
+				const size_t begin = chunks.begin(chunk);
+				const size_t end = chunks.end(chunk);
+				T partial = transform(data[begin]);
+				for (size_t i = begin + 1; i < end; i++)
+					partial = reduce(std::move(partial), transform(data[i]));
+				partials[chunk] = std::move(partial);
+			});
+
+			for (size_t chunk = 0; chunk < partials.size(); chunk++)
+				init = reduce(std::move(init), std::move(partials[chunk]));
+			return init;
+		}
+
+		template<typename Range, typename T, typename Reduce, typename Transform>
+		inline T transform_reduce(const Range& range, T init, Reduce reduce, Transform transform)
+		{
+			return parallel::transform_reduce(default_pool(), range, std::move(init), std::move(reduce), std::move(transform));
+		}
+
+		// init combined with every element of range through reduce, which has to be associative.
+		template<typename Range, typename T, typename Reduce>
+		inline T reduce(thread_pool& pool, const Range& range, T init, Reduce reduce)
+		{
+			using value_type = typename std::remove_pointer<decltype(range.data())>::type;
+			return parallel::transform_reduce(pool, range, std::move(init), std::move(reduce), [](const value_type& element) -> const value_type& { return element; });
+		}
+
+		template<typename Range, typename T, typename Reduce>
+		inline T reduce(const Range& range, T init, Reduce reduce)
+		{
+			return parallel::reduce(default_pool(), range, std::move(init), std::move(reduce));
+		}
+
+	} // !namespace parallel
+
+} // !namespace sad
+#endif
@@ -0,0 +1,541 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#if _WIN32 // Windows
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+
+#elif defined(__linux__) // Or #if __linux__
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/uio.h>
+	#include <unistd.h>
+
+#elif defined(__APPLE__) // Or #if _APPLE_
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/uio.h>
+	#include <unistd.h>
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "span.hpp"
+#include "stack_vector.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	// Why saving or loading failed.
+	enum class serial_status
+	{
+		ok,
+		io_error, // The file could not be opened, read, written or mapped.
+		bad_header, // Not written by save_binary, or written on a machine with the other byte order.
+		version_mismatch, // Written by a different version of the format.
+		type_mismatch, // The element size or alignment differs from T's.
+		truncated, // The file ends before the last element.
+		too_large, // More elements than the vector can hold.
+		checksum_mismatch, // The elements don't match the checksum they were written with.
+	};
+
+	// Start of a file written by save_binary. The elements follow at data_offset, a multiple of
+	// their alignment, so a mapped file can be used in place. Every field is in the byte order
+	// of the machine that wrote it.
+	struct serial_header
+	{
+		std::uint32_t magic; // serial_magic, reads back byte-swapped on the other byte order.
+		std::uint32_t version; // serial_version.
+		std::uint32_t element_size; // sizeof(T).
+		std::uint32_t element_align; // alignof(T).
+		std::uint64_t count; // Number of elements.
+		std::uint64_t checksum; // checksum64 of the elements.
+		std::uint64_t data_offset; // Offset of the first element from the start of the file.
+	};
+
+	static constexpr std::uint32_t serial_magic = 0x56444153u; // "SADV" on a little endian machine.
+	static constexpr std::uint32_t serial_version = 1;
+
+	// Hash of bytes for spotting corrupted or truncated files, not for security. Four independent
+	// multiply-rotate lanes over 8 byte words keep it close to memory bandwidth.
+	_NODISCARD inline std::uint64_t checksum64(const void* data, size_t bytes) noexcept
+	{
+		const std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+		const std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+
+		std::uint64_t lanes[4] = { prime1 + prime2, prime2, 0, 0 - prime1 };
+		const size_t length = bytes;
+		for (; bytes >= 32; bytes -= 32, p += 32) {
+			for (int i = 0; i < 4; i++) {
+				std::uint64_t word;
+				std::memcpy(&word, p + i * 8, 8);
+				lanes[i] += word * prime2;
+				lanes[i] = ((lanes[i] << 31) | (lanes[i] >> 33)) * prime1;
+			}
+		}
+
+		std::uint64_t hash = static_cast<std::uint64_t>(length) * prime1;
+		for (int i = 0; i < 4; i++)
+			hash = (((hash ^ lanes[i]) << 27) | ((hash ^ lanes[i]) >> 37)) * prime1 + prime2;
+
+		for (; bytes >= 8; bytes -= 8, p += 8) {
+			std::uint64_t word;
+			std::memcpy(&word, p, 8);
+			hash = (((hash ^ (word * prime2)) << 27) | ((hash ^ (word * prime2)) >> 37)) * prime1;
+		}
+		for (; bytes > 0; bytes--, p++)
+			hash = (((hash ^ (*p * prime1)) << 11) | ((hash ^ (*p * prime1)) >> 53)) * prime2;
+
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		return hash;
+	}
+
+	namespace detail {
+
+		// Elements start on their alignment, and never closer than a cache line to the header.
+		template<typename T>
+		constexpr size_t serial_data_offset() noexcept
+		{
+			return alignof(T) > 64 ? alignof(T) : 64;
+		}
+
+		template<typename T>
+		inline void serial_check_type() noexcept
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "sad: only trivially copyable types can be serialized");
+		}
+
+		// Header for count elements of T at data, followed by the padding up to the elements.
+		template<typename T>
+		struct serial_prefix
+		{
+			inline serial_prefix(const T* data, size_t count) noexcept
+			{
+				serial_header header;
+				header.magic = serial_magic;
+				header.version = serial_version;
+				header.element_size = static_cast<std::uint32_t>(sizeof(T));
+				header.element_align = static_cast<std::uint32_t>(alignof(T));
+				header.count = count;
+				header.checksum = checksum64(data, count * sizeof(T));
+				header.data_offset = serial_data_offset<T>();
+
+				std::memset(m_bytes, 0, sizeof(m_bytes));
+				std::memcpy(m_bytes, &header, sizeof(header));
+			}
+
+			unsigned char m_bytes[serial_data_offset<T>()];
+		};
+
+		// Check a header against T, and against the size of the file it came from.
+		template<typename T>
+		inline serial_status serial_check_header(const serial_header& header, std::uint64_t file_bytes) noexcept
+		{
+			if (header.magic != serial_magic)
+				return serial_status::bad_header;
+			if (header.version != serial_version)
+				return serial_status::version_mismatch;
+			if (header.element_size != sizeof(T) || header.element_align != alignof(T))
+				return serial_status::type_mismatch;
+			if (header.data_offset % alignof(T) != 0 || header.data_offset < sizeof(serial_header))
+				return serial_status::bad_header;
+			if (header.data_offset > file_bytes || header.count > (file_bytes - header.data_offset) / sizeof(T))
+				return serial_status::truncated;
+			return serial_status::ok;
+		}
+
+		// A whole file opened for reading or writing, closed on destruction.
+		class serial_file
+		{
+		public:
+			serial_file() = default;
+			serial_file(const serial_file&) = delete;
+			serial_file& operator=(const serial_file&) = delete;
+
+		#if _WIN32 // Windows
+			inline ~serial_file() { if (m_handle != INVALID_HANDLE_VALUE) ::CloseHandle(m_handle); }
+
+			inline bool open_read(const char* path) noexcept
+			{
+				m_handle = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+				return m_handle != INVALID_HANDLE_VALUE;
+			}
+
+			inline bool open_write(const char* path) noexcept
+			{
+				m_handle = ::CreateFileA(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+				return m_handle != INVALID_HANDLE_VALUE;
+			}
+
+			inline bool size(std::uint64_t& bytes) const noexcept
+			{
+				LARGE_INTEGER size;
+				if (!::GetFileSizeEx(m_handle, &size))
+					return false;
+				bytes = static_cast<std::uint64_t>(size.QuadPart);
+				return true;
+			}
+
+			inline bool read(void* dst, size_t bytes) noexcept
+			{
+				char* out = static_cast<char*>(dst);
+				while (bytes > 0) {
+					const DWORD chunk = bytes > 0x40000000u ? 0x40000000u : static_cast<DWORD>(bytes);
+					DWORD done = 0;
+					if (!::ReadFile(m_handle, out, chunk, &done, nullptr) || done == 0)
+						return false;
+					out += done;
+					bytes -= done;
+				}
+				return true;
+			}
+
+			// WriteFileGather needs page-sized, page-aligned buffers, so the two parts are written
+			// one after the other.
+			inline bool write(const void* a, size_t a_bytes, const void* b, size_t b_bytes) noexcept
+			{
+				return this->_write(a, a_bytes) && this->_write(b, b_bytes);
+			}
+
+			// Map the whole file read-only, the mapping outlives the file handle.
+			inline const void* map(size_t bytes) noexcept
+			{
+				HANDLE mapping = ::CreateFileMappingA(m_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mapping == nullptr)
+					return nullptr;
+				const void* base = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, bytes);
+				::CloseHandle(mapping);
+				return base;
+			}
+
+			static inline void unmap(const void* base, size_t) noexcept { ::UnmapViewOfFile(base); }
+
+		private:
+			inline bool _write(const void* src, size_t bytes) noexcept
+			{
+				const char* in = static_cast<const char*>(src);
+				while (bytes > 0) {
+					const DWORD chunk = bytes > 0x40000000u ? 0x40000000u : static_cast<DWORD>(bytes);
+					DWORD done = 0;
+					if (!::WriteFile(m_handle, in, chunk, &done, nullptr) || done == 0)
+						return false;
+					in += done;
+					bytes -= done;
+				}
+				return true;
+			}
+
+			HANDLE m_handle = INVALID_HANDLE_VALUE;
+
+		#else // POSIX
+			inline ~serial_file() { if (m_fd >= 0) ::close(m_fd); }
+
+			inline bool open_read(const char* path) noexcept
+			{
+				m_fd = ::open(path, O_RDONLY | O_CLOEXEC);
+				return m_fd >= 0;
+			}
+
+			inline bool open_write(const char* path) noexcept
+			{
+				m_fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+				return m_fd >= 0;
+			}
+
+			inline bool size(std::uint64_t& bytes) const noexcept
+			{
+				struct stat info;
+				if (::fstat(m_fd, &info) != 0)
+					return false;
+				bytes = static_cast<std::uint64_t>(info.st_size);
+				return true;
+			}
+
+			inline bool read(void* dst, size_t bytes) noexcept
+			{
+				char* out = static_cast<char*>(dst);
+				while (bytes > 0) {
+					const ssize_t done = ::read(m_fd, out, bytes);
+					if (done <= 0)
+						return false;
+					out += done;
+					bytes -= static_cast<size_t>(done);
+				}
+				return true;
+			}
+
+			// Both parts in a single writev, repeated only if the kernel writes less.
+			inline bool write(const void* a, size_t a_bytes, const void* b, size_t b_bytes) noexcept
+			{
+				struct iovec parts[2];
+				parts[0].iov_base = const_cast<void*>(a);
+				parts[0].iov_len = a_bytes;
+				parts[1].iov_base = const_cast<void*>(b);
+				parts[1].iov_len = b_bytes;
+
+				struct iovec* first = parts;
+				int count = b_bytes > 0 ? 2 : 1;
+				while (count > 0) {
+					ssize_t done = ::writev(m_fd, first, count);
+					if (done < 0)
+						return false;
+					for (; count > 0 && static_cast<size_t>(done) >= first->iov_len; first++, count--)
+						done -= static_cast<ssize_t>(first->iov_len);
+					if (count > 0) {
+						first->iov_base = static_cast<char*>(first->iov_base) + done;
+						first->iov_len -= static_cast<size_t>(done);
+					}
+				}
+				return true;
+			}
+
+			// Map the whole file read-only, the mapping outlives the file descriptor.
+			inline const void* map(size_t bytes) noexcept
+			{
+				void* base = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, m_fd, 0);
+				return base != MAP_FAILED ? base : nullptr;
+			}
+
+			static inline void unmap(const void* base, size_t bytes) noexcept { ::munmap(const_cast<void*>(base), bytes); }
+
+		private:
+			int m_fd = -1;
+		#endif
+		};
+
+	} // !namespace detail
+
+
+	// Write count elements of T to path as a serial_header followed by the raw elements, in a
+	// single write where the platform allows it.
+	template<typename T>
+	inline serial_status save_binary(const char* path, const T* data, size_t count)
+	{
+		detail::serial_check_type<T>();
+
+		const detail::serial_prefix<T> prefix(data, count);
+		detail::serial_file file;
+		if (!file.open_write(path) || !file.write(prefix.m_bytes, sizeof(prefix.m_bytes), data, count * sizeof(T)))
+			return serial_status::io_error;
+		return serial_status::ok;
+	}
+
+	template<typename T>
+	inline serial_status save_binary(const char* path, span<const T> elements)
+	{
+		return save_binary(path, elements.data(), elements.size());
+	}
+
+	template<typename T, std::size_t N, typename Allocator, typename Growth>
+	inline serial_status save_binary(const char* path, const stack_vector<T, N, Allocator, Growth>& vec)
+	{
+		return save_binary(path, vec.data(), vec.size());
+	}
+
+	// Replace the contents of vec with the elements saved at path, read straight into its buffer.
+	// vec is left empty on failure.
+	template<typename T, std::size_t N, typename Allocator, typename Growth>
+	inline serial_status load_binary(const char* path, stack_vector<T, N, Allocator, Growth>& vec)
+	{
+		detail::serial_check_type<T>();
+		vec.clear();
+
+		detail::serial_file file;
+		std::uint64_t file_bytes = 0;
+		if (!file.open_read(path) || !file.size(file_bytes))
+			return serial_status::io_error;
+
+		unsigned char prefix[detail::serial_data_offset<T>()];
+		serial_header header;
+		if (file_bytes < sizeof(prefix))
+			return serial_status::bad_header;
+		if (!file.read(prefix, sizeof(prefix)))
+			return serial_status::io_error;
+		std::memcpy(&header, prefix, sizeof(header));
+
+		serial_status status = detail::serial_check_header<T>(header, file_bytes);
+		if (status != serial_status::ok)
+			return status;
+		if (header.data_offset != sizeof(prefix))
+			return serial_status::bad_header;
+		if (header.count > vec.max_size())
+			return serial_status::too_large;
+
+		const size_t count = static_cast<size_t>(header.count);
+		span<T> space = vec.reserve_and_append_uninitialized(count);
+		if (!file.read(space.data(), space.size_bytes()))
+			return serial_status::io_error;
+		if (checksum64(space.data(), space.size_bytes()) != header.checksum)
+			return serial_status::checksum_mismatch;
+
+		vec.commit(count);
+		return serial_status::ok;
+	}
+
+
+	// Read-only view of a file written by save_binary, mapped into memory instead of read, so
+	// opening it costs no copy and the pages are shared with every other process mapping it.
+	// Offers the same read access as a const stack_vector: data(), operator[], begin()/end().
+	template<typename T>
+	class mapped_view
+	{
+	public:
+		using ValueType = T;
+		using iterator = const T*;
+		using const_iterator = const T*;
+
+		/* Allocation / Deallocation */
+	public:
+		mapped_view() = default;
+
+		inline mapped_view(mapped_view&& other) noexcept
+			: m_base(other.m_base), m_bytes(other.m_bytes), m_data(other.m_data), m_size(other.m_size)
+		{
+			other.m_base = nullptr;
+			other.m_data = nullptr;
+			other.m_size = 0;
+		}
+
+		inline mapped_view& operator=(mapped_view&& other) noexcept
+		{
+			if (this != &other) {
+				this->close();
+				m_base = other.m_base;
+				m_bytes = other.m_bytes;
+				m_data = other.m_data;
+				m_size = other.m_size;
+				other.m_base = nullptr;
+				other.m_data = nullptr;
+				other.m_size = 0;
+			}
+			return *this;
+		}
+
+		mapped_view(const mapped_view&) = delete;
+		mapped_view& operator=(const mapped_view&) = delete;
+
+		inline ~mapped_view()
+		{
+			this->close();
+		}
+
+		// Map the file at path. verify checks the elements against the checksum, which reads
+		// every page once; skip it for files that are trusted, to only fault in what is used.
+		inline serial_status open(const char* path, bool verify = true)
+		{
+			detail::serial_check_type<T>();
+			this->close();
+
+			detail::serial_file file;
+			std::uint64_t file_bytes = 0;
+			if (!file.open_read(path) || !file.size(file_bytes))
+				return serial_status::io_error;
+			if (file_bytes < sizeof(serial_header))
+				return serial_status::bad_header;
+			if (file_bytes > std::numeric_limits<size_t>::max())
+				return serial_status::too_large;
+
+			const void* base = file.map(static_cast<size_t>(file_bytes));
+			if (base == nullptr)
+				return serial_status::io_error;
+
+			serial_header header;
+			std::memcpy(&header, base, sizeof(header));
+			serial_status status = detail::serial_check_header<T>(header, file_bytes);
+
+			const T* data = reinterpret_cast<const T*>(static_cast<const char*>(base) + header.data_offset);
+			const size_t count = static_cast<size_t>(header.count);
+			if (status == serial_status::ok && verify && checksum64(data, count * sizeof(T)) != header.checksum)
+				status = serial_status::checksum_mismatch;
+
+			if (status != serial_status::ok) {
+				detail::serial_file::unmap(base, static_cast<size_t>(file_bytes));
+				return status;
+			}
+
+			m_base = base;
+			m_bytes = static_cast<size_t>(file_bytes);
+			m_data = data;
+			m_size = count;
+			return serial_status::ok;
+		}
+
+		// Unmap the file, leaving an empty view.
+		inline void close() noexcept
+		{
+			if (m_base != nullptr)
+				detail::serial_file::unmap(m_base, m_bytes);
+			m_base = nullptr;
+			m_data = nullptr;
+			m_size = 0;
+		}
+
+		_NODISCARD inline bool is_open() const noexcept { return m_base != nullptr; }
+
+		/*----------------------------------------------------------*/
+		/*						Element access						*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline const T& operator[](const size_t index) const noexcept
+		{
+			assert(index < m_size);
+			return m_data[index];
+		}
+
+		_NODISCARD inline const T& front() const noexcept
+		{
+			assert(m_size > 0);
+			return m_data[0];
+		}
+
+		_NODISCARD inline const T& back() const noexcept
+		{
+			assert(m_size > 0);
+			return m_data[m_size - 1];
+		}
+
+		_NODISCARD inline const T* data() const noexcept { return m_data; }
+		_NODISCARD inline span<const T> view() const noexcept { return span<const T>(m_data, m_size); }
+
+		/*----------------------------------------------------------*/
+		/*						Iterators							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline const_iterator begin() const noexcept { return m_data; }
+		_NODISCARD inline const_iterator end() const noexcept { return m_data + m_size; }
+		_NODISCARD inline const_iterator cbegin() const noexcept { return m_data; }
+		_NODISCARD inline const_iterator cend() const noexcept { return m_data + m_size; }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline size_t size() const noexcept { return m_size; }
+		_NODISCARD inline bool empty() const noexcept { return m_size == 0; }
+
+		/* Members */
+	private:
+		const void* m_base = nullptr; // Start of the mapping, the header.
+		size_t m_bytes = 0; // Size of the mapping.
+		const T* m_data = nullptr; // First element, inside the mapping.
+		size_t m_size = 0; // Number of elements.
+
+	}; // !mapped_view<T> class
+
+} // !namespace sad
+#endif
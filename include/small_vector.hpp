@@ -0,0 +1,16 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include "stack_vector.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	// Vector that keeps up to N elements inline and moves them to a block from Allocator
+	// once it grows past that, after which it keeps growing by 1.5x like any stack_vector.
+	// spilled() reports whether that has happened, which is handy when picking N.
+	template<typename T, std::size_t N, typename Allocator = std::allocator<T>, typename Growth = growth::geometric>
+	using small_vector = stack_vector<T, N, Allocator, Growth>;
+
+} // !namespace sad
+#endif
@@ -0,0 +1,378 @@
+#ifndef SOA_STACK_VECTOR_H
+#define SOA_STACK_VECTOR_H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "stack_vector.hpp"
+#include "span.hpp"
+
+// Alignment of every field array, 64 bytes covers a cache line and a full AVX-512 register.
+#ifndef SAD_SOA_ALIGNMENT
+	#define SAD_SOA_ALIGNMENT 64
+#endif
+
+// Field descriptor for member m of struct s, e.g. SAD_SOA_MEMBER(float3, x).
+#define SAD_SOA_MEMBER(s, m) sad::soa_member<s, decltype(s::m), &s::m>
+
+// Stack Allocated Data
+namespace sad {
+
+	// Describes one field of a soa_stack_vector as a data member of Struct, so whole Structs can be
+	// pushed in and read back while each member is still stored in its own array.
+	template<typename Struct, typename Type, Type Struct::*Member>
+	struct soa_member
+	{
+		using struct_type = Struct;
+		using type = Type;
+
+		static inline const Type& get(const Struct& value) noexcept { return value.*Member; }
+		static inline void set(Struct& value, const Type& field) { value.*Member = field; }
+	};
+
+	namespace detail {
+
+		// C++11 stand-in for std::index_sequence.
+		template<std::size_t... I>
+		struct index_sequence {};
+
+		template<std::size_t N, std::size_t... I>
+		struct make_index_sequence : make_index_sequence<N - 1, N - 1, I...> {};
+
+		template<std::size_t... I>
+		struct make_index_sequence<0, I...> { using type = index_sequence<I...>; };
+
+		// Stored type of a field, plain types are stored as they are.
+		template<typename Field>
+		struct soa_field_type { using type = Field; };
+
+		template<typename Struct, typename Type, Type Struct::*Member>
+		struct soa_field_type<soa_member<Struct, Type, Member>> { using type = Type; };
+
+		// The struct all fields are members of, or void when they aren't all soa_members of one struct.
+		template<typename... Fields>
+		struct soa_struct { using type = void; };
+
+		template<typename Struct, typename Type, Type Struct::*Member>
+		struct soa_struct<soa_member<Struct, Type, Member>> { using type = Struct; };
+
+		template<typename Struct, typename Type, Type Struct::*Member, typename Next, typename... Rest>
+		struct soa_struct<soa_member<Struct, Type, Member>, Next, Rest...>
+		{
+			using type = typename std::conditional<std::is_same<typename soa_struct<Next, Rest...>::type, Struct>::value, Struct, void>::type;
+		};
+
+		// Raw storage for N elements of T, starting on a SAD_SOA_ALIGNMENT boundary.
+		template<typename T, std::size_t N>
+		struct soa_column
+		{
+			inline T* _data() noexcept { return reinterpret_cast<T*>(m_bytes); }
+			inline const T* _data() const noexcept { return reinterpret_cast<const T*>(m_bytes); }
+
+			alignas(SAD_SOA_ALIGNMENT > alignof(T) ? SAD_SOA_ALIGNMENT : alignof(T)) unsigned char m_bytes[sizeof(T) * N];
+		};
+
+		// Evaluates each expression of a pack expansion in order, e.g. swallow{ (f(I), 0)... }.
+		using swallow = int[];
+
+		template<typename T>
+		inline void soa_destroy(T& value) noexcept { value.~T(); }
+
+	} // !namespace detail
+
+
+	// Fixed-capacity structure of arrays: every field is kept in its own contiguous, aligned
+	// array inside the object, so kernels can run full-width vector loads over one field.
+	// Fields are either plain types or soa_member descriptors of a struct, e.g.
+	//     sad::soa_stack_vector<256, float, float, float> xyz;
+	//     sad::soa_stack_vector<256, SAD_SOA_MEMBER(float3, x), SAD_SOA_MEMBER(float3, y), SAD_SOA_MEMBER(float3, z)> points;
+	// Going past N elements throws std::length_error, like stack_vector<T, N>.
+	template<std::size_t N, typename... Fields>
+	class soa_stack_vector
+	{
+		static_assert(N > 0, "sad::soa_stack_vector needs a capacity of at least one element");
+		static_assert(sizeof...(Fields) > 0, "sad::soa_stack_vector needs at least one field");
+
+	public:
+		// Stored type of field I.
+		template<std::size_t I>
+		using field_type = typename detail::soa_field_type<typename std::tuple_element<I, std::tuple<Fields...>>::type>::type;
+
+		// One element, as a tuple of its fields.
+		using ValueType = std::tuple<typename detail::soa_field_type<Fields>::type...>;
+
+		// Proxy references to one element's fields.
+		using reference = std::tuple<typename detail::soa_field_type<Fields>::type&...>;
+		using const_reference = std::tuple<const typename detail::soa_field_type<Fields>::type&...>;
+
+		// Struct the fields are members of, void when they are plain types.
+		using struct_type = typename detail::soa_struct<Fields...>::type;
+
+		static constexpr std::size_t field_count = sizeof...(Fields);
+
+		/* Allocation / Deallocation */
+	public:
+
+		// Default constructor.
+		inline soa_stack_vector() noexcept {}
+
+		// Copy constructor. Delegates so the destructor cleans up if copying an element throws.
+		inline soa_stack_vector(const soa_stack_vector& vec) : soa_stack_vector()
+		{
+			this->_copy_from(vec, indices());
+		}
+
+		// Move constructor
+		inline soa_stack_vector(soa_stack_vector&& vec) noexcept : soa_stack_vector()
+		{
+			this->_move_from(vec, indices());
+		}
+
+		// DESTROY!
+		~soa_stack_vector()
+		{
+			this->clear();
+		}
+
+		/*----------------------------------------------------------*/
+		/*						  Modifiers						    */
+		/*----------------------------------------------------------*/
+
+		// Append an element given as a tuple of its fields.
+		inline void push_back(const ValueType& value)
+		{
+			this->_check_capacity();
+			this->_push_tuple(value, indices());
+			m_size++;
+		}
+
+		// Append a struct, scattering its members over the field arrays.
+		template<typename S, typename = typename std::enable_if<std::is_same<S, struct_type>::value>::type>
+		inline void push_back(const S& value)
+		{
+			this->_check_capacity();
+			this->_push_struct(value, indices());
+			m_size++;
+		}
+
+		// Append an element, constructing each field in place from one argument.
+		template<typename... Args>
+		inline void emplace_back(Args&&... args)
+		{
+			static_assert(sizeof...(Args) == sizeof...(Fields), "sad::soa_stack_vector::emplace_back takes one argument per field");
+
+			this->_check_capacity();
+			this->_emplace(indices(), std::forward<Args>(args)...);
+			m_size++;
+		}
+
+		inline void pop_back() noexcept
+		{
+			if (m_size > 0) {
+				m_size--;
+				this->_destroy_at(m_size, indices());
+			}
+		}
+
+		// Destroy vector contents
+		inline void clear() noexcept
+		{
+			for (size_t i = 0; i < m_size; i++)
+				this->_destroy_at(i, indices());
+			m_size = 0;
+		}
+
+		/*----------------------------------------------------------*/
+		/*						Element access						*/
+		/*----------------------------------------------------------*/
+
+		// Proxy reference to the fields of the element at index.
+		_NODISCARD inline reference operator[](const size_t index) noexcept
+		{
+			assert(index < m_size);
+			return this->_reference(index, indices());
+		}
+
+		_NODISCARD inline const_reference operator[](const size_t index) const noexcept
+		{
+			assert(index < m_size);
+			return this->_const_reference(index, indices());
+		}
+
+		// Gather the members of the element at index back into a struct.
+		template<typename S = struct_type, typename = typename std::enable_if<!std::is_void<S>::value>::type>
+		_NODISCARD inline S get(const size_t index) const
+		{
+			assert(index < m_size);
+			S value;
+			this->_gather(value, index, indices());
+			return value;
+		}
+
+		// Field I of every element, as one contiguous array.
+		template<std::size_t I>
+		_NODISCARD inline span<field_type<I>> field() noexcept
+		{
+			return span<field_type<I>>(this->data<I>(), m_size);
+		}
+
+		template<std::size_t I>
+		_NODISCARD inline span<const field_type<I>> field() const noexcept
+		{
+			return span<const field_type<I>>(this->data<I>(), m_size);
+		}
+
+		// Start of the array of field I, aligned to SAD_SOA_ALIGNMENT.
+		template<std::size_t I>
+		_NODISCARD inline field_type<I>* data() noexcept { return std::get<I>(m_columns)._data(); }
+
+		template<std::size_t I>
+		_NODISCARD inline const field_type<I>* data() const noexcept { return std::get<I>(m_columns)._data(); }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity						    */
+		/*----------------------------------------------------------*/
+
+		// Get amount of elements.
+		_NODISCARD inline size_t size() const noexcept { return m_size; }
+
+		// Get amount of elements that can fit.
+		_NODISCARD inline size_t capacity() const noexcept { return N; }
+
+		_NODISCARD inline size_t max_size() const noexcept { return N; }
+
+		// Check if empty
+		_NODISCARD inline bool empty() const noexcept { return m_size == 0; }
+
+		/*----------------------------------------------------------*/
+		/*						Operator Overload					*/
+		/*----------------------------------------------------------*/
+	public:
+		void* operator new(size_t size); // Disable new
+		void operator delete(void*); // Disable delete
+
+		/* Assignment */
+		inline soa_stack_vector& operator=(const soa_stack_vector& rhs)
+		{
+			if (this != &rhs) {
+				this->clear();
+				this->_copy_from(rhs, indices());
+			}
+			return *this;
+		}
+
+		inline soa_stack_vector& operator=(soa_stack_vector&& rhs) noexcept
+		{
+			if (this != &rhs) {
+				this->clear();
+				this->_move_from(rhs, indices());
+			}
+			return *this;
+		}
+
+		/* Helper Functions */
+	private:
+		using indices = typename detail::make_index_sequence<sizeof...(Fields)>::type;
+
+		// Counts the fields of the element at m_index as they are built, and destroys them again if
+		// building one of the others throws, so a half-built element never leaks.
+		struct element_guard
+		{
+			soa_stack_vector& m_vector;
+			size_t m_index;
+			size_t m_built;
+			inline ~element_guard() { if (m_built != field_count) m_vector._destroy_fields(m_index, m_built, indices()); }
+		};
+
+		inline void _check_capacity() const
+		{
+			if (m_size >= N)
+				detail::throw_length_error("sad::soa_stack_vector: capacity exceeded");
+		}
+
+		template<std::size_t... I>
+		inline void _push_tuple(const ValueType& value, detail::index_sequence<I...>)
+		{
+			element_guard guard{ *this, m_size, 0 };
+			(void)detail::swallow{ 0, (new (this->data<I>() + m_size) field_type<I>(std::get<I>(value)), guard.m_built++, 0)... };
+		}
+
+		template<typename S, std::size_t... I>
+		inline void _push_struct(const S& value, detail::index_sequence<I...>)
+		{
+			element_guard guard{ *this, m_size, 0 };
+			(void)detail::swallow{ 0, (new (this->data<I>() + m_size) field_type<I>(std::tuple_element<I, std::tuple<Fields...>>::type::get(value)), guard.m_built++, 0)... };
+		}
+
+		template<std::size_t... I, typename... Args>
+		inline void _emplace(detail::index_sequence<I...>, Args&&... args)
+		{
+			element_guard guard{ *this, m_size, 0 };
+			(void)detail::swallow{ 0, (new (this->data<I>() + m_size) field_type<I>(std::forward<Args>(args)), guard.m_built++, 0)... };
+		}
+
+		template<std::size_t... I>
+		inline void _destroy_at(const size_t index, detail::index_sequence<I...>) noexcept
+		{
+			(void)detail::swallow{ 0, (detail::soa_destroy(this->data<I>()[index]), 0)... };
+		}
+
+		// Destroy the first count fields of the element at index.
+		template<std::size_t... I>
+		inline void _destroy_fields(const size_t index, const size_t count, detail::index_sequence<I...>) noexcept
+		{
+			(void)detail::swallow{ 0, ((I < count ? detail::soa_destroy(this->data<I>()[index]) : void()), 0)... };
+		}
+
+		template<std::size_t... I>
+		inline reference _reference(const size_t index, detail::index_sequence<I...>) noexcept
+		{
+			return reference(this->data<I>()[index]...);
+		}
+
+		template<std::size_t... I>
+		inline const_reference _const_reference(const size_t index, detail::index_sequence<I...>) const noexcept
+		{
+			return const_reference(this->data<I>()[index]...);
+		}
+
+		template<typename S, std::size_t... I>
+		inline void _gather(S& value, const size_t index, detail::index_sequence<I...>) const
+		{
+			(void)detail::swallow{ 0, (std::tuple_element<I, std::tuple<Fields...>>::type::set(value, this->data<I>()[index]), 0)... };
+		}
+
+		// Elements are counted one at a time, so a copy that throws leaves only whole elements behind.
+		template<std::size_t... I>
+		inline void _copy_from(const soa_stack_vector& other, detail::index_sequence<I...>)
+		{
+			for (size_t i = 0; i < other.m_size; i++) {
+				element_guard guard{ *this, i, 0 };
+				(void)detail::swallow{ 0, (new (this->data<I>() + i) field_type<I>(other.data<I>()[i]), guard.m_built++, 0)... };
+				m_size++;
+			}
+		}
+
+		template<std::size_t... I>
+		inline void _move_from(soa_stack_vector& other, detail::index_sequence<I...>)
+		{
+			for (size_t i = 0; i < other.m_size; i++) {
+				(void)detail::swallow{ 0, (new (this->data<I>() + i) field_type<I>(std::move(other.data<I>()[i])), 0)... };
+				m_size++;
+			}
+		}
+
+		/* Members */
+	private:
+		std::tuple<detail::soa_column<typename detail::soa_field_type<Fields>::type, N>...> m_columns; // One array per field.
+		size_t m_size = 0; // Size of the vector.
+
+	}; // !soa_stack_vector<N, Fields...> class
+
+	template<std::size_t N, typename... Fields>
+	constexpr std::size_t soa_stack_vector<N, Fields...>::field_count;
+
+} // !namespace sad
+#endif
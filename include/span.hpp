@@ -0,0 +1,370 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "stack_vector.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	// Count meaning "up to the end" for subspan.
+	static constexpr size_t dynamic_extent = static_cast<size_t>(-1);
+
+	template<typename T>
+	class strided_span;
+
+	namespace detail {
+
+		template<typename Container>
+		struct is_strided_span : std::false_type {};
+
+		template<typename T>
+		struct is_strided_span<strided_span<T>> : std::true_type {};
+
+		// Contiguous containers a span<T> can view: data() returns a pointer to T, or to a type
+		// that only differs from T in being less const, and size() gives the element count.
+		// A strided_span has both too, but its elements aren't contiguous.
+		template<typename Container, typename T>
+		struct is_span_source
+		{
+		private:
+			template<typename C, typename Pointer = decltype(std::declval<C&>().data()), typename = decltype(std::declval<C&>().size())>
+			static std::integral_constant<bool, std::is_pointer<Pointer>::value && std::is_convertible<typename std::remove_pointer<Pointer>::type(*)[], T(*)[]>::value
+				&& !is_strided_span<typename std::remove_cv<C>::type>::value> _test(int);
+
+			template<typename C>
+			static std::false_type _test(...);
+
+		public:
+			static constexpr bool value = decltype(_test<Container>(0))::value;
+		};
+
+		// M, const when the elements holding it are.
+		template<typename Pointer, typename M>
+		struct member_of { using type = typename std::conditional<std::is_const<typename std::remove_pointer<Pointer>::type>::value, const M, M>::type; };
+
+	} // !namespace detail
+
+
+	// Non-owning view of size contiguous elements, a C++11 stand-in for std::span.
+	// Converts implicitly from raw arrays and from any contiguous container with data() and
+	// size(), so stack_vector, std::vector and std::array all pass as a span without a copy.
+	template<typename T>
+	class span
+	{
+	public:
+		using ValueType = T;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+	public:
+		inline span() noexcept : m_data(nullptr), m_size(0) {}
+		inline span(T* data, size_t size) noexcept : m_data(data), m_size(size) {}
+		inline span(T* first, T* last) noexcept : m_data(first), m_size(static_cast<size_t>(last - first)) {}
+
+		template<std::size_t M>
+		inline span(T (&array)[M]) noexcept : m_data(array), m_size(M) {}
+
+		// View a container, or a span of less const elements.
+		template<typename Container, typename = typename std::enable_if<detail::is_span_source<Container, T>::value>::type>
+		inline span(Container& container) noexcept(noexcept(container.data())) : m_data(container.data()), m_size(container.size()) {}
+
+		template<typename Container, typename = typename std::enable_if<detail::is_span_source<const Container, T>::value>::type>
+		inline span(const Container& container) noexcept(noexcept(container.data())) : m_data(container.data()), m_size(container.size()) {}
+
+		/*----------------------------------------------------------*/
+		/*						Element access						*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline T& operator[](const size_t index) const noexcept
+		{
+			assert(index < m_size);
+			return m_data[index];
+		}
+
+		_NODISCARD inline T& front() const noexcept
+		{
+			assert(m_size > 0);
+			return m_data[0];
+		}
+
+		_NODISCARD inline T& back() const noexcept
+		{
+			assert(m_size > 0);
+			return m_data[m_size - 1];
+		}
+
+		_NODISCARD inline T* data() const noexcept { return m_data; }
+
+		/*----------------------------------------------------------*/
+		/*						  Sub-views							*/
+		/*----------------------------------------------------------*/
+
+		// The first count elements.
+		_NODISCARD inline span first(const size_t count) const noexcept
+		{
+			assert(count <= m_size);
+			return span(m_data, count);
+		}
+
+		// The last count elements.
+		_NODISCARD inline span last(const size_t count) const noexcept
+		{
+			assert(count <= m_size);
+			return span(m_data + (m_size - count), count);
+		}
+
+		// count elements from offset on, or all of them up to the end.
+		_NODISCARD inline span subspan(const size_t offset, const size_t count = dynamic_extent) const noexcept
+		{
+			assert(offset <= m_size);
+			assert(count == dynamic_extent || count <= m_size - offset);
+			return span(m_data + offset, count == dynamic_extent ? m_size - offset : count);
+		}
+
+		// The elements in [begin, end).
+		_NODISCARD inline span slice(const size_t begin, const size_t end) const noexcept
+		{
+			assert(begin <= end && end <= m_size);
+			return span(m_data + begin, end - begin);
+		}
+
+		// Every step-th element, starting with the first.
+		_NODISCARD inline strided_span<T> strided(const size_t step) const noexcept
+		{
+			assert(step > 0);
+			return strided_span<T>(m_data, (m_size + step - 1) / step, static_cast<std::ptrdiff_t>(step * sizeof(T)));
+		}
+
+		/*----------------------------------------------------------*/
+		/*						Iterators							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline iterator begin() const noexcept { return m_data; }
+		_NODISCARD inline iterator end() const noexcept { return m_data + m_size; }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity						    */
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline size_t size() const noexcept { return m_size; }
+		_NODISCARD inline size_t size_bytes() const noexcept { return m_size * sizeof(T); }
+		_NODISCARD inline bool empty() const noexcept { return m_size == 0; }
+
+		/* Members */
+	private:
+		T* m_data; // First element viewed.
+		size_t m_size; // Number of elements viewed.
+
+	}; // !span<T> class
+
+
+	// Non-owning view of size elements that are stride bytes apart, such as one member of every
+	// element of an array of structs, or every other element of an array. A negative stride walks
+	// backwards. Converts implicitly from a span, and so from anything a span converts from.
+	template<typename T>
+	class strided_span
+	{
+		using byte_pointer = typename std::conditional<std::is_const<T>::value, const char*, char*>::type;
+
+	public:
+		using ValueType = T;
+
+		class iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = typename std::remove_cv<T>::type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T*;
+			using reference = T&;
+
+			inline iterator() noexcept : m_base(nullptr), m_stride(0), m_index(0) {}
+			inline iterator(byte_pointer base, std::ptrdiff_t stride, difference_type index) noexcept : m_base(base), m_stride(stride), m_index(index) {}
+
+			_NODISCARD inline T& operator*() const noexcept { return *this->_at(m_index); }
+			_NODISCARD inline T* operator->() const noexcept { return this->_at(m_index); }
+			_NODISCARD inline T& operator[](const difference_type offset) const noexcept { return *this->_at(m_index + offset); }
+
+			/* Increment / Decrement */
+			inline iterator& operator++() noexcept { m_index++; return *this; }
+			inline iterator operator++(int) noexcept { iterator temp = *this; m_index++; return temp; }
+			inline iterator& operator--() noexcept { m_index--; return *this; }
+			inline iterator operator--(int) noexcept { iterator temp = *this; m_index--; return temp; }
+
+			/* Addition / Subtraction */
+			inline iterator& operator+=(const difference_type val) noexcept { m_index += val; return *this; }
+			inline iterator& operator-=(const difference_type val) noexcept { m_index -= val; return *this; }
+			_NODISCARD inline iterator operator+(const difference_type val) const noexcept { return iterator(m_base, m_stride, m_index + val); }
+			_NODISCARD inline iterator operator-(const difference_type val) const noexcept { return iterator(m_base, m_stride, m_index - val); }
+			_NODISCARD inline difference_type operator-(const iterator& other) const noexcept { return m_index - other.m_index; }
+
+			/* Comparison */
+			_NODISCARD inline bool operator==(const iterator& other) const noexcept { return m_index == other.m_index && m_base == other.m_base; }
+			_NODISCARD inline bool operator!=(const iterator& other) const noexcept { return !(*this == other); }
+			_NODISCARD inline bool operator<(const iterator& other) const noexcept { return m_index < other.m_index; }
+			_NODISCARD inline bool operator>(const iterator& other) const noexcept { return m_index > other.m_index; }
+			_NODISCARD inline bool operator<=(const iterator& other) const noexcept { return m_index <= other.m_index; }
+			_NODISCARD inline bool operator>=(const iterator& other) const noexcept { return m_index >= other.m_index; }
+
+		private:
+			inline T* _at(const difference_type index) const noexcept { return reinterpret_cast<T*>(m_base + index * m_stride); }
+
+			// The position is kept as an index and the address only worked out to dereference it, so
+			// end() never points anywhere: with any stride but sizeof(T) it would lie past one past
+			// the last element, or before the first with a negative stride.
+			byte_pointer m_base; // First element of the span.
+			std::ptrdiff_t m_stride; // Bytes between elements.
+			difference_type m_index; // Current element.
+		};
+
+		using const_iterator = iterator;
+
+	public:
+		inline strided_span() noexcept : m_data(nullptr), m_size(0), m_stride(sizeof(T)) {}
+
+		// size elements, the first at first and each next one stride bytes after the last.
+		inline strided_span(T* first, size_t size, std::ptrdiff_t stride) noexcept
+			: m_data(reinterpret_cast<byte_pointer>(first)), m_size(size), m_stride(stride) {}
+
+		// Every element of a span, or of anything a span converts from.
+		inline strided_span(span<T> elements) noexcept
+			: m_data(reinterpret_cast<byte_pointer>(elements.data())), m_size(elements.size()), m_stride(sizeof(T)) {}
+
+		template<typename Container, typename = typename std::enable_if<detail::is_span_source<Container, T>::value>::type>
+		inline strided_span(Container& container) noexcept(noexcept(container.data())) : strided_span(span<T>(container)) {}
+
+		template<typename Container, typename = typename std::enable_if<detail::is_span_source<const Container, T>::value>::type>
+		inline strided_span(const Container& container) noexcept(noexcept(container.data())) : strided_span(span<T>(container)) {}
+
+		// Less const elements.
+		template<typename U, typename = typename std::enable_if<!std::is_same<U, T>::value && std::is_convertible<U(*)[], T(*)[]>::value>::type>
+		inline strided_span(const strided_span<U>& other) noexcept
+			: m_data(reinterpret_cast<byte_pointer>(other.data())), m_size(other.size()), m_stride(other.stride()) {}
+
+		/*----------------------------------------------------------*/
+		/*						Element access						*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline T& operator[](const size_t index) const noexcept
+		{
+			assert(index < m_size);
+			return *reinterpret_cast<T*>(m_data + static_cast<std::ptrdiff_t>(index) * m_stride);
+		}
+
+		_NODISCARD inline T& front() const noexcept
+		{
+			assert(m_size > 0);
+			return (*this)[0];
+		}
+
+		_NODISCARD inline T& back() const noexcept
+		{
+			assert(m_size > 0);
+			return (*this)[m_size - 1];
+		}
+
+		// The first element.
+		_NODISCARD inline T* data() const noexcept { return reinterpret_cast<T*>(m_data); }
+
+		// Bytes from one element to the next.
+		_NODISCARD inline std::ptrdiff_t stride() const noexcept { return m_stride; }
+
+		// Check if the elements are back to back, so data() can be used as a plain array.
+		_NODISCARD inline bool is_contiguous() const noexcept { return m_stride == static_cast<std::ptrdiff_t>(sizeof(T)); }
+
+		/*----------------------------------------------------------*/
+		/*						  Sub-views							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline strided_span first(const size_t count) const noexcept
+		{
+			assert(count <= m_size);
+			return strided_span(this->data(), count, m_stride);
+		}
+
+		_NODISCARD inline strided_span last(const size_t count) const noexcept
+		{
+			assert(count <= m_size);
+			return this->_sub(m_size - count, count);
+		}
+
+		_NODISCARD inline strided_span subspan(const size_t offset, const size_t count = dynamic_extent) const noexcept
+		{
+			assert(offset <= m_size);
+			assert(count == dynamic_extent || count <= m_size - offset);
+			return this->_sub(offset, count == dynamic_extent ? m_size - offset : count);
+		}
+
+		_NODISCARD inline strided_span slice(const size_t begin, const size_t end) const noexcept
+		{
+			assert(begin <= end && end <= m_size);
+			return this->_sub(begin, end - begin);
+		}
+
+		// Every step-th element, starting with the first.
+		_NODISCARD inline strided_span strided(const size_t step) const noexcept
+		{
+			assert(step > 0);
+			return strided_span(this->data(), (m_size + step - 1) / step, m_stride * static_cast<std::ptrdiff_t>(step));
+		}
+
+		// The same elements, last to first.
+		_NODISCARD inline strided_span reversed() const noexcept
+		{
+			return m_size == 0 ? *this : strided_span(this->_at(m_size - 1), m_size, -m_stride);
+		}
+
+		/*----------------------------------------------------------*/
+		/*						Iterators							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline iterator begin() const noexcept { return iterator(m_data, m_stride, 0); }
+		_NODISCARD inline iterator end() const noexcept { return iterator(m_data, m_stride, static_cast<std::ptrdiff_t>(m_size)); }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity						    */
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline size_t size() const noexcept { return m_size; }
+		_NODISCARD inline bool empty() const noexcept { return m_size == 0; }
+
+		/* Helper Functions */
+	private:
+		inline T* _at(const size_t index) const noexcept { return reinterpret_cast<T*>(m_data + static_cast<std::ptrdiff_t>(index) * m_stride); }
+
+		// count elements from index on. An empty view keeps data() rather than working out an
+		// address that may lie past the elements.
+		inline strided_span _sub(const size_t index, const size_t count) const noexcept
+		{
+			return strided_span(count == 0 ? this->data() : this->_at(index), count, m_stride);
+		}
+
+		/* Members */
+	private:
+		byte_pointer m_data; // First element viewed.
+		size_t m_size; // Number of elements viewed.
+		std::ptrdiff_t m_stride; // Bytes from one element to the next.
+
+	}; // !strided_span<T> class
+
+	// View of one data member of every element of a contiguous container or span, e.g. the x
+	// components of an array of float3:
+	//     sad::strided_span<float> xs = sad::strided_member(points, &float3::x);
+	template<typename Container, typename M, typename S>
+	_NODISCARD inline strided_span<typename detail::member_of<decltype(std::declval<Container&>().data()), M>::type> strided_member(Container&& elements, M S::* member) noexcept
+	{
+		using member_type = typename detail::member_of<decltype(std::declval<Container&>().data()), M>::type;
+		const std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(sizeof(*elements.data()));
+		if (elements.size() == 0)
+			return strided_span<member_type>(nullptr, 0, stride);
+		return strided_span<member_type>(&(elements.data()->*member), elements.size(), stride);
+	}
+
+} // !namespace sad
+#endif
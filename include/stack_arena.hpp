@@ -0,0 +1,242 @@
+#ifndef STACK_ARENA_H
+#define STACK_ARENA_H
+
+#if _WIN32 // Windows
+	#include <malloc.h>
+
+#elif defined(__linux__) // Or #if __linux__
+	#include <alloca.h>
+
+#elif defined(__APPLE__) // Or #if _APPLE_
+	#include <alloca.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+#include "stack_budget.hpp"
+#include "stack_vector.hpp"
+
+// alloca under each compiler's name.
+#if _WIN32
+	#define SAD_ALLOCA(bytes) _alloca(bytes)
+#else
+	#define SAD_ALLOCA(bytes) alloca(bytes)
+#endif
+
+// Reserve bytes of stack in the calling frame and wrap them in a sad::stack_arena called name.
+// The memory is released when the calling function returns, so the arena must not outlive it.
+// When bytes would eat into the stack's safety margin (see stack_budget.hpp) the arena takes its
+// block from the heap instead, on_stack() tells which one it got.
+// bytes is evaluated once, and alloca gets a statement of its own since several ABIs can't take
+// it among a call's arguments. That makes the macro a few statements, so use it where a
+// declaration could go.
+#define SAD_STACK_ARENA(name, bytes) \
+	const std::size_t name##_stack_bytes = (bytes); \
+	void* name##_stack_block = nullptr; \
+	if (sad::stack_can_fit(name##_stack_bytes)) \
+		name##_stack_block = SAD_ALLOCA(name##_stack_bytes); \
+	sad::stack_arena name(name##_stack_block, name##_stack_bytes)
+
+// Stack Allocated Data
+namespace sad {
+
+	// Monotonic bump allocator over a block of memory owned by the caller, or by the arena itself
+	// when it was given no buffer.
+	// Allocations are never freed one by one (except the most recent one), instead the arena is
+	// rewound to a marker taken earlier, or reset altogether, in O(1).
+	class stack_arena
+	{
+	public:
+		// Position in the arena that can be rewound to later.
+		using marker = char*;
+
+		// Rewinds the arena to where it was when the scope was opened.
+		class scope
+		{
+		public:
+			inline explicit scope(stack_arena& arena) noexcept : m_arena(arena), m_marker(arena.mark()) {}
+			inline ~scope() { m_arena.rewind(m_marker); }
+
+			scope(const scope&) = delete;
+			scope& operator=(const scope&) = delete;
+
+		private:
+			stack_arena& m_arena;
+			marker m_marker;
+		};
+
+	public:
+		// A null buffer makes the arena allocate its bytes from the heap, and free them when destroyed.
+		inline stack_arena(void* buffer, size_t bytes)
+			: m_owned(buffer == nullptr && bytes > 0 ? ::operator new(bytes) : nullptr)
+		{
+			m_begin = static_cast<char*>(m_owned ? m_owned : buffer);
+			m_top = m_begin;
+			m_end = m_begin + bytes;
+		}
+
+		inline ~stack_arena()
+		{
+			::operator delete(m_owned);
+		}
+
+		stack_arena(const stack_arena&) = delete;
+		stack_arena& operator=(const stack_arena&) = delete;
+
+		/*----------------------------------------------------------*/
+		/*						  Allocation						*/
+		/*----------------------------------------------------------*/
+
+		// Bump allocate bytes aligned to alignment (a power of two).
+		_NODISCARD inline void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+		{
+			char* ptr = this->_align(m_top, alignment);
+			if (ptr > m_end || bytes > static_cast<size_t>(m_end - ptr))
+				detail::throw_bad_alloc();
+
+			m_top = ptr + bytes;
+			return ptr;
+		}
+
+		// Only the most recent allocation is given back, anything else waits for a rewind.
+		inline void deallocate(void* ptr, size_t bytes) noexcept
+		{
+			if (static_cast<char*>(ptr) + bytes == m_top)
+				m_top = static_cast<char*>(ptr);
+		}
+
+		// Grow the most recent allocation to new_bytes without moving it.
+		inline bool try_extend(void* ptr, size_t old_bytes, size_t new_bytes) noexcept
+		{
+			char* block = static_cast<char*>(ptr);
+			if (block + old_bytes != m_top || new_bytes > static_cast<size_t>(m_end - block))
+				return false;
+
+			m_top = block + new_bytes;
+			return true;
+		}
+
+		/*----------------------------------------------------------*/
+		/*						   Markers							*/
+		/*----------------------------------------------------------*/
+
+		// Remember the current position.
+		_NODISCARD inline marker mark() const noexcept { return m_top; }
+
+		// Free everything allocated since m was taken.
+		inline void rewind(marker m) noexcept
+		{
+			assert(m >= m_begin && m <= m_top);
+			m_top = m;
+		}
+
+		// Free everything.
+		inline void reset() noexcept { m_top = m_begin; }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline size_t used() const noexcept { return static_cast<size_t>(m_top - m_begin); }
+		_NODISCARD inline size_t remaining() const noexcept { return static_cast<size_t>(m_end - m_top); }
+		_NODISCARD inline size_t capacity() const noexcept { return static_cast<size_t>(m_end - m_begin); }
+
+		// Check if the block is the caller's rather than one the arena fell back to the heap for.
+		_NODISCARD inline bool on_stack() const noexcept { return m_owned == nullptr; }
+
+		/* Helper Functions */
+	private:
+		static inline char* _align(char* ptr, size_t alignment) noexcept
+		{
+			const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(ptr);
+			const std::uintptr_t aligned = (address + (alignment - 1)) & ~static_cast<std::uintptr_t>(alignment - 1);
+			return ptr + (aligned - address);
+		}
+
+		/* Members */
+	protected:
+		char* m_begin; // Start of the block.
+		char* m_top; // Next free byte.
+		char* m_end; // One past the end of the block.
+		void* m_owned; // Heap block allocated in place of the caller's, if any.
+
+	}; // !stack_arena class
+
+
+	// Arena with its block of Bytes embedded in the object, for when the size is known up front.
+	template<size_t Bytes>
+	class fixed_stack_arena : public stack_arena
+	{
+	public:
+		inline fixed_stack_arena() noexcept : stack_arena(m_storage, Bytes) {}
+
+	private:
+		alignas(std::max_align_t) char m_storage[Bytes];
+
+	}; // !fixed_stack_arena<Bytes> class
+
+
+	// Allocator handing out memory from a stack_arena, for use as the Allocator of a stack_vector.
+	template<typename T>
+	class arena_allocator
+	{
+	public:
+		using value_type = T;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		template<typename U>
+		struct rebind { using other = arena_allocator<U>; };
+
+	public:
+		inline arena_allocator(stack_arena& arena) noexcept : m_arena(&arena) {}
+
+		template<typename U>
+		inline arena_allocator(const arena_allocator<U>& other) noexcept : m_arena(other.m_arena) {}
+
+		_NODISCARD inline T* allocate(size_t n)
+		{
+			if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+				detail::throw_bad_alloc();
+
+			return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		inline void deallocate(T* ptr, size_t n) noexcept
+		{
+			m_arena->deallocate(ptr, n * sizeof(T));
+		}
+
+		// Grow the block at ptr from old_n to new_n elements without moving it.
+		inline bool try_extend(T* ptr, size_t old_n, size_t new_n) noexcept
+		{
+			if (new_n > std::numeric_limits<size_t>::max() / sizeof(T))
+				return false;
+
+			return m_arena->try_extend(ptr, old_n * sizeof(T), new_n * sizeof(T));
+		}
+
+		_NODISCARD inline stack_arena& arena() const noexcept { return *m_arena; }
+
+		template<typename U>
+		inline bool operator==(const arena_allocator<U>& rhs) const noexcept { return m_arena == rhs.m_arena; }
+
+		template<typename U>
+		inline bool operator!=(const arena_allocator<U>& rhs) const noexcept { return m_arena != rhs.m_arena; }
+
+	private:
+		template<typename U>
+		friend class arena_allocator;
+
+		stack_arena* m_arena;
+
+	}; // !arena_allocator<T> class
+
+
+	// stack_vector allocating from a stack_arena once it outgrows its N inline elements.
+	template<typename T, std::size_t N = 0, typename Growth = growth::geometric>
+	using arena_vector = stack_vector<T, N, arena_allocator<T>, Growth>;
+
+} // !namespace sad
+#endif
@@ -0,0 +1,120 @@
+#ifndef STACK_BUDGET_H
+#define STACK_BUDGET_H
+
+#if _WIN32 // Windows
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+
+#elif defined(__linux__) // Or #if __linux__
+	#include <pthread.h>
+
+#elif defined(__APPLE__) // Or #if _APPLE_
+	#include <pthread.h>
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+
+// Stack to leave untouched below any alloca, for the calls the program still makes afterwards.
+// Can also be changed at run time with sad::set_stack_safety_margin.
+#ifndef SAD_STACK_SAFETY_MARGIN
+	#define SAD_STACK_SAFETY_MARGIN (64 * 1024)
+#endif
+
+// Stack Allocated Data
+namespace sad {
+
+	// Address range of a thread's stack, low being the end it grows towards.
+	struct stack_bounds
+	{
+		const char* low = nullptr;
+		const char* high = nullptr;
+	};
+
+	namespace detail {
+
+		// Ask the OS where the calling thread's stack is, both null when it can't tell.
+		inline stack_bounds query_stack_bounds() noexcept
+		{
+			stack_bounds bounds;
+
+		#if _WIN32
+			ULONG_PTR low = 0, high = 0;
+			GetCurrentThreadStackLimits(&low, &high);
+			bounds.low = reinterpret_cast<const char*>(low);
+			bounds.high = reinterpret_cast<const char*>(high);
+
+		#elif defined(__linux__)
+			pthread_attr_t attr;
+			if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+				void* address = nullptr;
+				size_t size = 0;
+				if (pthread_attr_getstack(&attr, &address, &size) == 0) {
+					bounds.low = static_cast<const char*>(address);
+					bounds.high = bounds.low + size;
+				}
+				pthread_attr_destroy(&attr);
+			}
+
+		#elif defined(__APPLE__)
+			const pthread_t self = pthread_self();
+			bounds.high = static_cast<const char*>(pthread_get_stackaddr_np(self));
+			bounds.low = bounds.high - pthread_get_stacksize_np(self);
+		#endif
+
+			return bounds;
+		}
+
+		inline std::atomic<size_t>& stack_safety_margin() noexcept
+		{
+			static std::atomic<size_t> margin{ SAD_STACK_SAFETY_MARGIN };
+			return margin;
+		}
+
+	} // !namespace detail
+
+	// Stack of the calling thread, asked of the OS once per thread.
+	inline const stack_bounds& current_stack_bounds() noexcept
+	{
+		static thread_local const stack_bounds bounds = detail::query_stack_bounds();
+		return bounds;
+	}
+
+	// Bytes of stack left below the caller, as good as unlimited when the bounds are unknown.
+	inline size_t stack_remaining() noexcept
+	{
+		const stack_bounds& bounds = current_stack_bounds();
+		if (bounds.low == nullptr)
+			return std::numeric_limits<size_t>::max();
+
+		const char marker = 0;
+		const char* top = &marker;
+		return top > bounds.low ? static_cast<size_t>(top - bounds.low) : 0;
+	}
+
+	inline size_t stack_safety_margin() noexcept
+	{
+		return detail::stack_safety_margin().load(std::memory_order_relaxed);
+	}
+
+	inline void set_stack_safety_margin(size_t bytes) noexcept
+	{
+		detail::stack_safety_margin().store(bytes, std::memory_order_relaxed);
+	}
+
+	// Check if bytes can be alloca'd here and still leave the safety margin.
+	inline bool stack_can_fit(size_t bytes) noexcept
+	{
+		const size_t remaining = stack_remaining();
+		const size_t margin = stack_safety_margin();
+		return remaining > margin && bytes <= remaining - margin;
+	}
+
+} // !namespace sad
+#endif
@@ -0,0 +1,315 @@
+#ifndef STACK_DEQUE_H
+#define STACK_DEQUE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "span.hpp"
+#include "stack_vector.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	// Fixed-capacity double-ended vector of N elements stored inside the object.
+	// The elements stay contiguous somewhere in the middle of the buffer, with headroom on both
+	// sides, so pushing or popping at either end is O(1) and iterating is a plain array walk.
+	// Only when one end runs into the edge of the buffer are the elements shifted back to the
+	// middle, splitting the free space evenly between both ends.
+	// A shift costs O(size) and buys (N - size) / 2 pushes at the end that ran out, so the pushes
+	// are O(1) amortised only while the deque stays well below N; a queue running near capacity
+	// (push_back plus pop_front) pays O(size / (N - size)) per push. Such a FIFO is better off as a
+	// stack_ring<T, N, ring::single_thread>, which wraps around instead and is O(1) at any size.
+	// Pushing past N elements throws std::length_error (or aborts when exceptions are disabled).
+	template<typename T, std::size_t N>
+	class stack_deque : private detail::inline_storage<T, N>
+	{
+		static_assert(N > 0, "sad::stack_deque: N must be greater than 0");
+
+	public:
+		using ValueType = T;
+		#if _WIN32 // Windows
+			using iterator = iterator<stack_deque>;
+			using const_iterator = const_iterator<stack_deque>;
+
+		#elif defined(__linux__) // Or #if __linux__
+			using iterator = class iterator<stack_deque>;
+			using const_iterator = class const_iterator<stack_deque>;
+
+		#elif defined(__APPLE__) // Or #if _APPLE_
+			using iterator = class iterator<stack_deque>;
+			using const_iterator = class const_iterator<stack_deque>;
+		#endif
+
+		/* Allocation / Deallocation */
+	public:
+		stack_deque() = default;
+
+		// Copy constructor, the copy starts out centred.
+		inline stack_deque(const stack_deque& other)
+		{
+			this->_copy_from(other);
+		}
+
+		// Move constructor, moves the elements one by one.
+		inline stack_deque(stack_deque&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+		{
+			m_begin = m_end = (N - other.size()) / 2;
+			for (size_t i = other.m_begin; i < other.m_end; i++, m_end++)
+				::new (static_cast<void*>(this->_slot(m_end))) T(std::move(*other._slot(i)));
+		}
+
+		inline stack_deque& operator=(const stack_deque& other)
+		{
+			if (this != &other) {
+				this->clear();
+				this->_copy_from(other);
+			}
+			return *this;
+		}
+
+		inline stack_deque& operator=(stack_deque&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+		{
+			if (this != &other) {
+				this->clear();
+				m_begin = m_end = (N - other.size()) / 2;
+				for (size_t i = other.m_begin; i < other.m_end; i++, m_end++)
+					::new (static_cast<void*>(this->_slot(m_end))) T(std::move(*other._slot(i)));
+			}
+			return *this;
+		}
+
+		// DESTROY!
+		inline ~stack_deque()
+		{
+			this->_destroy(m_begin, m_end);
+		}
+
+		/*----------------------------------------------------------*/
+		/*						  Modifiers						    */
+		/*----------------------------------------------------------*/
+
+		// Construct an element at the back.
+		template<typename... Args>
+		inline T& emplace_back(Args&&... args)
+		{
+			if (m_end == N)
+				return this->_recenter_emplace_back(std::forward<Args>(args)...);
+
+			T* slot = this->_slot(m_end);
+			::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+			m_end++;
+			return *slot;
+		}
+
+		// Construct an element at the front.
+		template<typename... Args>
+		inline T& emplace_front(Args&&... args)
+		{
+			if (m_begin == 0)
+				return this->_recenter_emplace_front(std::forward<Args>(args)...);
+
+			T* slot = this->_slot(m_begin - 1);
+			::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+			m_begin--;
+			return *slot;
+		}
+
+		inline void push_back(const T& value) { this->emplace_back(value); }
+		inline void push_back(T&& value) { this->emplace_back(std::move(value)); }
+		inline void push_front(const T& value) { this->emplace_front(value); }
+		inline void push_front(T&& value) { this->emplace_front(std::move(value)); }
+
+		// Destroy the last element.
+		inline void pop_back() noexcept
+		{
+			assert(m_begin < m_end);
+			this->_slot(--m_end)->~T();
+		}
+
+		// Destroy the first element.
+		inline void pop_front() noexcept
+		{
+			assert(m_begin < m_end);
+			this->_slot(m_begin++)->~T();
+		}
+
+		// Destroy every element, leaving the same headroom at both ends.
+		inline void clear() noexcept
+		{
+			this->_destroy(m_begin, m_end);
+			m_begin = m_end = N / 2;
+		}
+
+		/*----------------------------------------------------------*/
+		/*						Element access						*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline T& operator[](const size_t index) noexcept
+		{
+			assert(index < this->size());
+			return *this->_slot(m_begin + index);
+		}
+
+		_NODISCARD inline const T& operator[](const size_t index) const noexcept
+		{
+			assert(index < this->size());
+			return *this->_slot(m_begin + index);
+		}
+
+		_NODISCARD inline T& front() noexcept
+		{
+			assert(m_begin < m_end);
+			return *this->_slot(m_begin);
+		}
+
+		_NODISCARD inline const T& front() const noexcept
+		{
+			assert(m_begin < m_end);
+			return *this->_slot(m_begin);
+		}
+
+		_NODISCARD inline T& back() noexcept
+		{
+			assert(m_begin < m_end);
+			return *this->_slot(m_end - 1);
+		}
+
+		_NODISCARD inline const T& back() const noexcept
+		{
+			assert(m_begin < m_end);
+			return *this->_slot(m_end - 1);
+		}
+
+		// The elements are contiguous, front first. Moved by pushes that have to re-centre.
+		_NODISCARD inline T* data() noexcept { return this->_slot(m_begin); }
+		_NODISCARD inline const T* data() const noexcept { return this->_slot(m_begin); }
+		_NODISCARD inline span<T> view() noexcept { return span<T>(this->data(), this->size()); }
+		_NODISCARD inline span<const T> view() const noexcept { return span<const T>(this->data(), this->size()); }
+
+		/*----------------------------------------------------------*/
+		/*						Iterators							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline iterator begin() noexcept { return iterator(this->_slot(m_begin)); }
+		_NODISCARD inline iterator end() noexcept { return iterator(this->_slot(m_end)); }
+		_NODISCARD inline const_iterator begin() const noexcept { return const_iterator(this->_mutable_slot(m_begin)); }
+		_NODISCARD inline const_iterator end() const noexcept { return const_iterator(this->_mutable_slot(m_end)); }
+		_NODISCARD inline const_iterator cbegin() const noexcept { return this->begin(); }
+		_NODISCARD inline const_iterator cend() const noexcept { return this->end(); }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline size_t size() const noexcept { return m_end - m_begin; }
+		_NODISCARD inline bool empty() const noexcept { return m_begin == m_end; }
+		_NODISCARD inline bool full() const noexcept { return this->size() == N; }
+		_NODISCARD static constexpr size_t capacity() noexcept { return N; }
+
+		// Elements that fit in front of the first one before the deque has to re-centre.
+		_NODISCARD inline size_t front_headroom() const noexcept { return m_begin; }
+
+		// Elements that fit after the last one before the deque has to re-centre.
+		_NODISCARD inline size_t back_headroom() const noexcept { return N - m_end; }
+
+		/* Helper Functions */
+	private:
+		using relocatable = std::integral_constant<bool, is_trivially_relocatable<T>::value>;
+
+		inline T* _slot(size_t index) noexcept { return this->_inline_data() + index; }
+		inline const T* _slot(size_t index) const noexcept { return this->_inline_data() + index; }
+
+		// The iterator templates only take a T*, even for const_iterator.
+		inline T* _mutable_slot(size_t index) const noexcept { return const_cast<T*>(this->_inline_data()) + index; }
+
+		inline void _copy_from(const stack_deque& other)
+		{
+			m_begin = m_end = (N - other.size()) / 2;
+			for (size_t i = other.m_begin; i < other.m_end; i++, m_end++)
+				::new (static_cast<void*>(this->_slot(m_end))) T(*other._slot(i));
+		}
+
+		inline void _destroy(size_t begin, size_t end) noexcept
+		{
+			for (size_t i = begin; i < end; i++)
+				this->_slot(i)->~T();
+		}
+
+		// emplace_back and emplace_front once that end is at the edge of the buffer. The element is
+		// built before re-centering, args may refer to an element that is about to move.
+		template<typename... Args>
+		inline T& _recenter_emplace_back(Args&&... args)
+		{
+			T value(std::forward<Args>(args)...);
+			this->_recenter();
+
+			T* slot = this->_slot(m_end);
+			::new (static_cast<void*>(slot)) T(std::move(value));
+			m_end++;
+			return *slot;
+		}
+
+		template<typename... Args>
+		inline T& _recenter_emplace_front(Args&&... args)
+		{
+			T value(std::forward<Args>(args)...);
+			this->_recenter();
+
+			T* slot = this->_slot(m_begin - 1);
+			::new (static_cast<void*>(slot)) T(std::move(value));
+			m_begin--;
+			return *slot;
+		}
+
+		// One end hit the edge of the buffer: move the elements so the free space is split evenly.
+		inline void _recenter()
+		{
+			const size_t count = this->size();
+			if (count == N)
+				detail::throw_length_error("sad::stack_deque: capacity exceeded");
+
+			// With an odd amount of free space, the extra slot goes to the end that ran out.
+			const size_t free = N - count;
+			const size_t begin = m_begin == 0 ? (free + 1) / 2 : free / 2;
+			this->_shift(begin, relocatable());
+			m_begin = begin;
+			m_end = begin + count;
+		}
+
+		inline void _shift(size_t begin, std::true_type) noexcept
+		{
+			std::memmove(static_cast<void*>(this->_slot(begin)), static_cast<const void*>(this->_slot(m_begin)), this->size() * sizeof(T));
+		}
+
+		// Relocate one element at a time, starting from the end moving towards the new position so
+		// every destination slot has already been vacated.
+		inline void _shift(size_t begin, std::false_type)
+		{
+			const size_t count = this->size();
+			if (begin < m_begin) {
+				for (size_t i = 0; i < count; i++) {
+					::new (static_cast<void*>(this->_slot(begin + i))) T(std::move(*this->_slot(m_begin + i)));
+					this->_slot(m_begin + i)->~T();
+				}
+			}
+			else {
+				for (size_t i = count; i-- > 0;) {
+					::new (static_cast<void*>(this->_slot(begin + i))) T(std::move(*this->_slot(m_begin + i)));
+					this->_slot(m_begin + i)->~T();
+				}
+			}
+		}
+
+		/* Members */
+	private:
+		size_t m_begin = N / 2; // Index of the first element.
+		size_t m_end = N / 2; // Index past the last element.
+
+	}; // !stack_deque<T, N> class
+
+} // !namespace sad
+#endif
@@ -0,0 +1,724 @@
+#ifndef STACK_FLAT_MAP_H
+#define STACK_FLAT_MAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "span.hpp"
+#include "stack_vector.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define SAD_FLAT_SSE2 1
+#else
+	#define SAD_FLAT_SSE2 0
+#endif
+
+// Lookups in tables of up to this many keys count the smaller keys in one linear pass (SIMD for
+// int32, float and double keys under std::less), larger tables are binary searched.
+#ifndef SAD_FLAT_LINEAR_THRESHOLD
+	#define SAD_FLAT_LINEAR_THRESHOLD 32
+#endif
+
+// Stack Allocated Data
+namespace sad {
+
+	namespace detail {
+
+		// Called when at() is given a key that isn't there.
+		[[noreturn]] inline void throw_out_of_range(const char* what)
+		{
+			#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+				throw std::out_of_range(what);
+			#else
+				(void)what;
+				std::abort();
+			#endif
+		}
+
+		// Number of the n sorted keys for which before(key) holds, i.e. where the first key it
+		// doesn't hold for sits. Branchless: the compare picks the next base with a conditional move.
+		template<typename Key, typename Before>
+		inline size_t flat_partition_point(const Key* keys, size_t n, Before before)
+		{
+			const Key* base = keys;
+			while (n > 1) {
+				const size_t half = n / 2;
+				base = before(base[half]) ? base + half : base;
+				n -= half;
+			}
+			return static_cast<size_t>(base - keys) + ((n == 1 && before(*base)) ? 1 : 0);
+		}
+
+		// Same, for a handful of keys: every key is compared, with no branch to mispredict.
+		template<typename Key, typename Before>
+		inline size_t flat_count_before(const Key* keys, size_t n, Before before)
+		{
+			size_t count = 0;
+			for (size_t i = 0; i < n; i++)
+				count += before(keys[i]) ? 1 : 0;
+			return count;
+		}
+
+		// Keys less than key, in a linear pass.
+		template<typename Key, typename Compare>
+		inline size_t flat_count_less(const Key* keys, size_t n, const Key& key, const Compare& comp)
+		{
+			return detail::flat_count_before(keys, n, [&](const Key& k) { return comp(k, key); });
+		}
+
+	#if SAD_FLAT_SSE2
+		inline size_t flat_count_less(const std::int32_t* keys, size_t n, const std::int32_t& key, const std::less<std::int32_t>&) noexcept
+		{
+			const __m128i needle = _mm_set1_epi32(key);
+			__m128i counts = _mm_setzero_si128();
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) // Each lane that compares true is -1.
+				counts = _mm_sub_epi32(counts, _mm_cmplt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), needle));
+
+			alignas(16) std::int32_t lanes[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), counts);
+			size_t count = static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+			for (; i < n; i++)
+				count += keys[i] < key ? 1 : 0;
+			return count;
+		}
+
+		inline size_t flat_count_less(const float* keys, size_t n, const float& key, const std::less<float>&) noexcept
+		{
+			const __m128 needle = _mm_set1_ps(key);
+			__m128i counts = _mm_setzero_si128();
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+				counts = _mm_sub_epi32(counts, _mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(keys + i), needle)));
+
+			alignas(16) std::int32_t lanes[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), counts);
+			size_t count = static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+			for (; i < n; i++)
+				count += keys[i] < key ? 1 : 0;
+			return count;
+		}
+
+		inline size_t flat_count_less(const double* keys, size_t n, const double& key, const std::less<double>&) noexcept
+		{
+			const __m128d needle = _mm_set1_pd(key);
+			__m128i counts = _mm_setzero_si128();
+			size_t i = 0;
+			for (; i + 2 <= n; i += 2)
+				counts = _mm_sub_epi64(counts, _mm_castpd_si128(_mm_cmplt_pd(_mm_loadu_pd(keys + i), needle)));
+
+			alignas(16) std::int64_t lanes[2];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), counts);
+			size_t count = static_cast<size_t>(lanes[0] + lanes[1]);
+			for (; i < n; i++)
+				count += keys[i] < key ? 1 : 0;
+			return count;
+		}
+	#endif
+
+		// Index of the first of the n sorted keys not less than key.
+		template<typename Key, typename Compare>
+		inline size_t flat_lower_bound(const Key* keys, size_t n, const Key& key, const Compare& comp)
+		{
+			if (n <= SAD_FLAT_LINEAR_THRESHOLD)
+				return detail::flat_count_less(keys, n, key, comp);
+
+			return detail::flat_partition_point(keys, n, [&](const Key& k) { return comp(k, key); });
+		}
+
+		// Index of the first of the n sorted keys greater than key.
+		template<typename Key, typename Compare>
+		inline size_t flat_upper_bound(const Key* keys, size_t n, const Key& key, const Compare& comp)
+		{
+			const auto not_greater = [&](const Key& k) { return !comp(key, k); };
+			if (n <= SAD_FLAT_LINEAR_THRESHOLD)
+				return detail::flat_count_before(keys, n, not_greater);
+
+			return detail::flat_partition_point(keys, n, not_greater);
+		}
+
+		// What a merge of two sorted sequences a and b keeps.
+		enum class flat_merge_mode { merge_union, merge_intersection, merge_difference };
+
+		// Most keys a merge can produce, capped to what a fixed-capacity result can hold.
+		inline size_t flat_merge_capacity(size_t size_a, size_t size_b, size_t max_size, flat_merge_mode mode) noexcept
+		{
+			return std::min(mode == flat_merge_mode::merge_union ? size_a + size_b : size_a, max_size);
+		}
+
+		// Walk two sorted sequences of size_a and size_b keys in step, calling take_a(i) or take_b(j)
+		// for each element of the result in order. Keys found in both are taken from a, keys
+		// repeated within b only count once.
+		template<typename Compare, typename KeyA, typename KeyB, typename TakeA, typename TakeB>
+		inline void flat_merge(size_t size_a, size_t size_b, const Compare& comp, KeyA key_a, KeyB key_b, TakeA take_a, TakeB take_b, flat_merge_mode mode)
+		{
+			const bool keep_a = mode != flat_merge_mode::merge_intersection;
+			const bool keep_b = mode == flat_merge_mode::merge_union;
+			const bool keep_both = mode != flat_merge_mode::merge_difference;
+
+			size_t i = 0, j = 0;
+			while (i < size_a || j < size_b) {
+				// Skip repeats within b.
+				if (j > 0 && j < size_b && !comp(key_b(j - 1), key_b(j))) {
+					j++;
+					continue;
+				}
+
+				if (j == size_b || (i < size_a && comp(key_a(i), key_b(j)))) {
+					if (keep_a)
+						take_a(i);
+					i++;
+				}
+				else if (i == size_a || comp(key_b(j), key_a(i))) {
+					if (keep_b)
+						take_b(j);
+					j++;
+				}
+				else {
+					if (keep_both)
+						take_a(i);
+					i++;
+					j++;
+				}
+			}
+		}
+
+		// Debug check that [first, last) is sorted by key.
+		template<typename It, typename KeyOf, typename Compare>
+		inline bool flat_is_sorted(It first, It last, KeyOf key_of, const Compare& comp)
+		{
+			for (It next = first; first != last && ++next != last; ++first) {
+				if (comp(key_of(*next), key_of(*first)))
+					return false;
+			}
+			return true;
+		}
+
+	} // !namespace detail
+
+
+	// Sorted set of unique keys kept contiguously in a stack_vector<Key, N, Allocator>, so a lookup
+	// touches a few cache lines instead of walking a tree. Small sets are scanned linearly (with
+	// SIMD where possible), larger ones binary searched without branches. Inserting or erasing
+	// shifts the keys after it, so it suits tables that are built once and searched a lot.
+	template<typename Key, std::size_t N = 0, typename Compare = std::less<Key>, typename Allocator = void>
+	class stack_flat_set
+	{
+	public:
+		using ValueType = Key;
+		using key_type = Key;
+		using key_compare = Compare;
+		using container_type = stack_vector<Key, N, Allocator>;
+		using iterator = const Key*;
+		using const_iterator = const Key*;
+
+		/* Allocation / Deallocation */
+	public:
+		stack_flat_set() = default;
+
+		inline explicit stack_flat_set(const Compare& comp) : m_comp(comp) {}
+
+		// Any order, duplicates are dropped.
+		inline stack_flat_set(std::initializer_list<Key> init_list, const Compare& comp = Compare()) : m_comp(comp)
+		{
+			for (const Key& key : init_list)
+				this->insert(key);
+		}
+
+		/*----------------------------------------------------------*/
+		/*						   Modifiers						*/
+		/*----------------------------------------------------------*/
+
+		// Insert key unless it is already there, returning where it is and if it was inserted.
+		inline std::pair<iterator, bool> insert(const Key& key)
+		{
+			const size_t index = this->_lower_bound(key);
+			if (index < m_keys.size() && !m_comp(key, m_keys[index]))
+				return std::make_pair(this->data() + index, false);
+
+			m_keys.insert(m_keys.cbegin() + index, key);
+			return std::make_pair(this->data() + index, true);
+		}
+
+		inline std::pair<iterator, bool> insert(Key&& key)
+		{
+			const size_t index = this->_lower_bound(key);
+			if (index < m_keys.size() && !m_comp(key, m_keys[index]))
+				return std::make_pair(this->data() + index, false);
+
+			m_keys.emplace(m_keys.cbegin() + index, std::move(key));
+			return std::make_pair(this->data() + index, true);
+		}
+
+		// Merge a range of keys already sorted by Compare in one pass, instead of shifting the
+		// set for every key. Keys already in the set, or repeated in the range, are dropped.
+		template<typename RandomIt>
+		inline void insert_sorted_range(RandomIt first, RandomIt last)
+		{
+			static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<RandomIt>::iterator_category>::value,
+				"sad::stack_flat_set::insert_sorted_range: needs random access iterators");
+			assert(detail::flat_is_sorted(first, last, [](const Key& key) -> const Key& { return key; }, m_comp));
+
+			container_type merged;
+			merged.reserve(std::min(m_keys.size() + static_cast<size_t>(last - first), merged.max_size()));
+			detail::flat_merge(m_keys.size(), static_cast<size_t>(last - first), m_comp,
+				[this](size_t i) -> const Key& { return m_keys[i]; },
+				[first](size_t j) -> const Key& { return first[j]; },
+				[&](size_t i) { merged.push_back(std::move(m_keys[i])); },
+				[&](size_t j) { merged.push_back(first[j]); },
+				detail::flat_merge_mode::merge_union);
+			m_keys = std::move(merged);
+		}
+
+		// Erase key, returning how many were erased (0 or 1).
+		inline size_t erase(const Key& key)
+		{
+			const size_t index = this->_lower_bound(key);
+			if (index == m_keys.size() || m_comp(key, m_keys[index]))
+				return 0;
+
+			m_keys.erase(m_keys.cbegin() + index);
+			return 1;
+		}
+
+		inline iterator erase(const_iterator position)
+		{
+			const size_t index = static_cast<size_t>(position - this->data());
+			m_keys.erase(m_keys.cbegin() + index);
+			return this->data() + index;
+		}
+
+		inline void clear() noexcept { m_keys.clear(); }
+		inline void reserve(size_t capacity) { m_keys.reserve(capacity); }
+
+		/*----------------------------------------------------------*/
+		/*						    Lookup							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline iterator find(const Key& key) const
+		{
+			const size_t index = this->_lower_bound(key);
+			return (index < m_keys.size() && !m_comp(key, m_keys[index])) ? this->data() + index : this->end();
+		}
+
+		_NODISCARD inline bool contains(const Key& key) const { return this->find(key) != this->end(); }
+		_NODISCARD inline size_t count(const Key& key) const { return this->contains(key) ? 1 : 0; }
+
+		_NODISCARD inline iterator lower_bound(const Key& key) const { return this->data() + this->_lower_bound(key); }
+		_NODISCARD inline iterator upper_bound(const Key& key) const { return this->data() + detail::flat_upper_bound(this->data(), m_keys.size(), key, m_comp); }
+
+		/*----------------------------------------------------------*/
+		/*						Element access						*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline const Key& operator[](const size_t index) const noexcept { return m_keys[index]; }
+		_NODISCARD inline const Key* data() const noexcept { return m_keys.data(); }
+		_NODISCARD inline span<const Key> keys() const noexcept { return span<const Key>(this->data(), m_keys.size()); }
+		_NODISCARD inline const Compare& key_comp() const noexcept { return m_comp; }
+
+		/*----------------------------------------------------------*/
+		/*						Iterators							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline const_iterator begin() const noexcept { return this->data(); }
+		_NODISCARD inline const_iterator end() const noexcept { return this->data() + m_keys.size(); }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline size_t size() const noexcept { return m_keys.size(); }
+		_NODISCARD inline bool empty() const noexcept { return m_keys.size() == 0; }
+		_NODISCARD inline size_t capacity() const noexcept { return m_keys.capacity(); }
+
+		/* Operators */
+		_NODISCARD inline bool operator==(const stack_flat_set& rhs) const { return m_keys == rhs.m_keys; }
+		_NODISCARD inline bool operator!=(const stack_flat_set& rhs) const { return m_keys != rhs.m_keys; }
+
+		/* Set operations */
+	public:
+		// Keys in a, b or both.
+		friend inline stack_flat_set set_union(const stack_flat_set& a, const stack_flat_set& b)
+		{
+			return stack_flat_set::_merge(a, b, detail::flat_merge_mode::merge_union);
+		}
+
+		// Keys in both a and b.
+		friend inline stack_flat_set set_intersection(const stack_flat_set& a, const stack_flat_set& b)
+		{
+			return stack_flat_set::_merge(a, b, detail::flat_merge_mode::merge_intersection);
+		}
+
+		// Keys in a but not in b.
+		friend inline stack_flat_set set_difference(const stack_flat_set& a, const stack_flat_set& b)
+		{
+			return stack_flat_set::_merge(a, b, detail::flat_merge_mode::merge_difference);
+		}
+
+		/* Helper Functions */
+	private:
+		inline size_t _lower_bound(const Key& key) const { return detail::flat_lower_bound(this->data(), m_keys.size(), key, m_comp); }
+
+		static inline stack_flat_set _merge(const stack_flat_set& a, const stack_flat_set& b, detail::flat_merge_mode mode)
+		{
+			stack_flat_set result(a.m_comp);
+			result.m_keys.reserve(detail::flat_merge_capacity(a.size(), b.size(), result.m_keys.max_size(), mode));
+			detail::flat_merge(a.size(), b.size(), a.m_comp,
+				[&a](size_t i) -> const Key& { return a.m_keys[i]; },
+				[&b](size_t j) -> const Key& { return b.m_keys[j]; },
+				[&](size_t i) { result.m_keys.push_back(a.m_keys[i]); },
+				[&](size_t j) { result.m_keys.push_back(b.m_keys[j]); },
+				mode);
+			return result;
+		}
+
+		/* Members */
+	private:
+		container_type m_keys; // Sorted by m_comp, no two equivalent.
+		Compare m_comp;
+
+	}; // !stack_flat_set<Key, N, Compare, Allocator> class
+
+
+	// Sorted map from unique keys to values, keys and values each in their own stack_vector so a
+	// lookup only reads keys. Searched like stack_flat_set; iterators dereference to a
+	// std::pair<const Key&, T&> built on the fly.
+	template<typename Key, typename T, std::size_t N = 0, typename Compare = std::less<Key>, typename Allocator = void>
+	class stack_flat_map
+	{
+	public:
+		using ValueType = T;
+		using key_type = Key;
+		using mapped_type = T;
+		using key_compare = Compare;
+		using key_container_type = stack_vector<Key, N, Allocator>;
+		using mapped_container_type = stack_vector<T, N, Allocator>;
+
+		// Index into the map, dereferencing to a pair of references to the key and its value.
+		template<bool Const>
+		class basic_iterator
+		{
+		public:
+			using map_type = typename std::conditional<Const, const stack_flat_map, stack_flat_map>::type;
+			using mapped_reference = typename std::conditional<Const, const T&, T&>::type;
+			using reference = std::pair<const Key&, mapped_reference>;
+
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = std::pair<Key, T>;
+			using difference_type = std::ptrdiff_t;
+
+			// Lets it-> reach the members of the pair made by operator*.
+			struct pointer
+			{
+				reference m_pair;
+				inline const reference* operator->() const noexcept { return &m_pair; }
+			};
+
+		public:
+			inline basic_iterator() noexcept : m_map(nullptr), m_index(0) {}
+			inline basic_iterator(map_type* map, size_t index) noexcept : m_map(map), m_index(index) {}
+
+			// Any iterator converts to a const one.
+			template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+			inline basic_iterator(const basic_iterator<OtherConst>& other) noexcept : m_map(other.m_map), m_index(other.m_index) {}
+
+			_NODISCARD inline const Key& key() const noexcept { return m_map->m_keys[m_index]; }
+			_NODISCARD inline mapped_reference value() const noexcept { return m_map->m_values[m_index]; }
+			_NODISCARD inline size_t index() const noexcept { return m_index; }
+
+			_NODISCARD inline reference operator*() const noexcept { return reference(this->key(), this->value()); }
+			_NODISCARD inline pointer operator->() const noexcept { return pointer{ **this }; }
+
+			inline basic_iterator& operator++() noexcept { m_index++; return *this; }
+			inline basic_iterator operator++(int) noexcept { basic_iterator temp = *this; m_index++; return temp; }
+			inline basic_iterator& operator--() noexcept { m_index--; return *this; }
+			inline basic_iterator operator--(int) noexcept { basic_iterator temp = *this; m_index--; return temp; }
+
+			inline basic_iterator& operator+=(const difference_type val) noexcept { m_index += val; return *this; }
+			inline basic_iterator& operator-=(const difference_type val) noexcept { m_index -= val; return *this; }
+			_NODISCARD inline basic_iterator operator+(const difference_type val) const noexcept { return basic_iterator(m_map, m_index + val); }
+			_NODISCARD inline basic_iterator operator-(const difference_type val) const noexcept { return basic_iterator(m_map, m_index - val); }
+			_NODISCARD inline difference_type operator-(const basic_iterator& rhs) const noexcept { return static_cast<difference_type>(m_index) - static_cast<difference_type>(rhs.m_index); }
+
+			_NODISCARD inline bool operator==(const basic_iterator& rhs) const noexcept { return m_index == rhs.m_index; }
+			_NODISCARD inline bool operator!=(const basic_iterator& rhs) const noexcept { return m_index != rhs.m_index; }
+			_NODISCARD inline bool operator<(const basic_iterator& rhs) const noexcept { return m_index < rhs.m_index; }
+
+		private:
+			friend class stack_flat_map;
+
+			template<bool>
+			friend class basic_iterator;
+
+			map_type* m_map;
+			size_t m_index;
+		};
+
+		using iterator = basic_iterator<false>;
+		using const_iterator = basic_iterator<true>;
+
+		/* Allocation / Deallocation */
+	public:
+		stack_flat_map() = default;
+
+		inline explicit stack_flat_map(const Compare& comp) : m_comp(comp) {}
+
+		// Any order, for repeated keys the first one wins.
+		inline stack_flat_map(std::initializer_list<std::pair<Key, T>> init_list, const Compare& comp = Compare()) : m_comp(comp)
+		{
+			for (const std::pair<Key, T>& entry : init_list)
+				this->insert(entry.first, entry.second);
+		}
+
+		/*----------------------------------------------------------*/
+		/*						   Modifiers						*/
+		/*----------------------------------------------------------*/
+
+		// Construct the value for key in place unless key is already there.
+		template<typename K, typename... Args>
+		inline std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+		{
+			const size_t index = this->_lower_bound(key);
+			if (index < m_keys.size() && !m_comp(key, m_keys[index]))
+				return std::make_pair(iterator(this, index), false);
+
+			this->_insert_at(index, std::forward<K>(key), std::forward<Args>(args)...);
+			return std::make_pair(iterator(this, index), true);
+		}
+
+		inline std::pair<iterator, bool> insert(const Key& key, const T& value) { return this->try_emplace(key, value); }
+		inline std::pair<iterator, bool> insert(const std::pair<Key, T>& entry) { return this->try_emplace(entry.first, entry.second); }
+
+		// Insert key, or overwrite its value if it is already there.
+		template<typename V>
+		inline std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value)
+		{
+			const size_t index = this->_lower_bound(key);
+			if (index < m_keys.size() && !m_comp(key, m_keys[index])) {
+				m_values[index] = std::forward<V>(value);
+				return std::make_pair(iterator(this, index), false);
+			}
+
+			this->_insert_at(index, key, std::forward<V>(value));
+			return std::make_pair(iterator(this, index), true);
+		}
+
+		// Merge a range of pairs already sorted by key in one pass, instead of shifting the map for
+		// every pair. Keys already in the map, or repeated in the range, keep their first value.
+		template<typename RandomIt>
+		inline void insert_sorted_range(RandomIt first, RandomIt last)
+		{
+			static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<RandomIt>::iterator_category>::value,
+				"sad::stack_flat_map::insert_sorted_range: needs random access iterators");
+			assert(detail::flat_is_sorted(first, last, [](const typename std::iterator_traits<RandomIt>::value_type& entry) -> const Key& { return entry.first; }, m_comp));
+
+			const size_t count = static_cast<size_t>(last - first);
+			key_container_type keys;
+			mapped_container_type values;
+			keys.reserve(std::min(m_keys.size() + count, keys.max_size()));
+			values.reserve(std::min(m_keys.size() + count, values.max_size()));
+
+			detail::flat_merge(m_keys.size(), count, m_comp,
+				[this](size_t i) -> const Key& { return m_keys[i]; },
+				[first](size_t j) -> const Key& { return first[j].first; },
+				[&](size_t i) { keys.push_back(std::move(m_keys[i])); values.push_back(std::move(m_values[i])); },
+				[&](size_t j) { keys.push_back(first[j].first); values.push_back(first[j].second); },
+				detail::flat_merge_mode::merge_union);
+
+			m_keys = std::move(keys);
+			m_values = std::move(values);
+		}
+
+		// Erase key, returning how many were erased (0 or 1).
+		inline size_t erase(const Key& key)
+		{
+			const size_t index = this->_lower_bound(key);
+			if (index == m_keys.size() || m_comp(key, m_keys[index]))
+				return 0;
+
+			this->_erase_at(index);
+			return 1;
+		}
+
+		inline iterator erase(const_iterator position)
+		{
+			this->_erase_at(position.m_index);
+			return iterator(this, position.m_index);
+		}
+
+		inline void clear() noexcept
+		{
+			m_keys.clear();
+			m_values.clear();
+		}
+
+		inline void reserve(size_t capacity)
+		{
+			m_keys.reserve(capacity);
+			m_values.reserve(capacity);
+		}
+
+		/*----------------------------------------------------------*/
+		/*						    Lookup							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline iterator find(const Key& key) { return iterator(this, this->_find(key)); }
+		_NODISCARD inline const_iterator find(const Key& key) const { return const_iterator(this, this->_find(key)); }
+
+		_NODISCARD inline bool contains(const Key& key) const { return this->_find(key) != m_keys.size(); }
+		_NODISCARD inline size_t count(const Key& key) const { return this->contains(key) ? 1 : 0; }
+
+		_NODISCARD inline iterator lower_bound(const Key& key) { return iterator(this, this->_lower_bound(key)); }
+		_NODISCARD inline const_iterator lower_bound(const Key& key) const { return const_iterator(this, this->_lower_bound(key)); }
+		_NODISCARD inline iterator upper_bound(const Key& key) { return iterator(this, this->_upper_bound(key)); }
+		_NODISCARD inline const_iterator upper_bound(const Key& key) const { return const_iterator(this, this->_upper_bound(key)); }
+
+		// Value of key, or nullptr if it isn't there.
+		_NODISCARD inline T* get(const Key& key)
+		{
+			const size_t index = this->_find(key);
+			return index != m_keys.size() ? &m_values[index] : nullptr;
+		}
+
+		_NODISCARD inline const T* get(const Key& key) const
+		{
+			const size_t index = this->_find(key);
+			return index != m_keys.size() ? &m_values[index] : nullptr;
+		}
+
+		/*----------------------------------------------------------*/
+		/*						Element access						*/
+		/*----------------------------------------------------------*/
+
+		// Value of key, default constructed first if it isn't there.
+		inline T& operator[](const Key& key) { return this->try_emplace(key).first.value(); }
+
+		// Value of key, throwing std::out_of_range (or aborting without exceptions) if it isn't there.
+		_NODISCARD inline T& at(const Key& key)
+		{
+			T* value = this->get(key);
+			if (value == nullptr)
+				detail::throw_out_of_range("sad::stack_flat_map::at: key not found");
+			return *value;
+		}
+
+		_NODISCARD inline const T& at(const Key& key) const
+		{
+			const T* value = this->get(key);
+			if (value == nullptr)
+				detail::throw_out_of_range("sad::stack_flat_map::at: key not found");
+			return *value;
+		}
+
+		// Sorted keys, and the values in the same order.
+		_NODISCARD inline span<const Key> keys() const noexcept { return span<const Key>(m_keys.data(), m_keys.size()); }
+		_NODISCARD inline span<T> values() noexcept { return span<T>(m_values.data(), m_values.size()); }
+		_NODISCARD inline span<const T> values() const noexcept { return span<const T>(m_values.data(), m_values.size()); }
+		_NODISCARD inline const Compare& key_comp() const noexcept { return m_comp; }
+
+		/*----------------------------------------------------------*/
+		/*						Iterators							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline iterator begin() noexcept { return iterator(this, 0); }
+		_NODISCARD inline iterator end() noexcept { return iterator(this, m_keys.size()); }
+		_NODISCARD inline const_iterator begin() const noexcept { return const_iterator(this, 0); }
+		_NODISCARD inline const_iterator end() const noexcept { return const_iterator(this, m_keys.size()); }
+		_NODISCARD inline const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+		_NODISCARD inline const_iterator cend() const noexcept { return const_iterator(this, m_keys.size()); }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline size_t size() const noexcept { return m_keys.size(); }
+		_NODISCARD inline bool empty() const noexcept { return m_keys.size() == 0; }
+		_NODISCARD inline size_t capacity() const noexcept { return m_keys.capacity(); }
+
+		/* Operators */
+		_NODISCARD inline bool operator==(const stack_flat_map& rhs) const { return m_keys == rhs.m_keys && m_values == rhs.m_values; }
+		_NODISCARD inline bool operator!=(const stack_flat_map& rhs) const { return !(*this == rhs); }
+
+		/* Set operations, by key. Values of keys found in both come from a. */
+	public:
+		friend inline stack_flat_map set_union(const stack_flat_map& a, const stack_flat_map& b)
+		{
+			return stack_flat_map::_merge(a, b, detail::flat_merge_mode::merge_union);
+		}
+
+		friend inline stack_flat_map set_intersection(const stack_flat_map& a, const stack_flat_map& b)
+		{
+			return stack_flat_map::_merge(a, b, detail::flat_merge_mode::merge_intersection);
+		}
+
+		friend inline stack_flat_map set_difference(const stack_flat_map& a, const stack_flat_map& b)
+		{
+			return stack_flat_map::_merge(a, b, detail::flat_merge_mode::merge_difference);
+		}
+
+		/* Helper Functions */
+	private:
+		inline size_t _lower_bound(const Key& key) const { return detail::flat_lower_bound(m_keys.data(), m_keys.size(), key, m_comp); }
+		inline size_t _upper_bound(const Key& key) const { return detail::flat_upper_bound(m_keys.data(), m_keys.size(), key, m_comp); }
+
+		// Index of key, or size() if it isn't there.
+		inline size_t _find(const Key& key) const
+		{
+			const size_t index = this->_lower_bound(key);
+			return (index < m_keys.size() && !m_comp(key, m_keys[index])) ? index : m_keys.size();
+		}
+
+		// Insert the key and then the value, taking the key back out if the value throws.
+		template<typename K, typename... Args>
+		inline void _insert_at(size_t index, K&& key, Args&&... args)
+		{
+			m_keys.emplace(m_keys.cbegin() + index, std::forward<K>(key));
+
+			struct rollback
+			{
+				key_container_type& m_keys;
+				size_t m_index;
+				bool m_done;
+				inline ~rollback() { if (!m_done) m_keys.erase(m_keys.cbegin() + m_index); }
+			} guard{ m_keys, index, false };
+
+			m_values.emplace(m_values.cbegin() + index, std::forward<Args>(args)...);
+			guard.m_done = true;
+		}
+
+		inline void _erase_at(size_t index)
+		{
+			m_keys.erase(m_keys.cbegin() + index);
+			m_values.erase(m_values.cbegin() + index);
+		}
+
+		static inline stack_flat_map _merge(const stack_flat_map& a, const stack_flat_map& b, detail::flat_merge_mode mode)
+		{
+			stack_flat_map result(a.m_comp);
+			result.reserve(detail::flat_merge_capacity(a.size(), b.size(), result.m_keys.max_size(), mode));
+			detail::flat_merge(a.size(), b.size(), a.m_comp,
+				[&a](size_t i) -> const Key& { return a.m_keys[i]; },
+				[&b](size_t j) -> const Key& { return b.m_keys[j]; },
+				[&](size_t i) { result.m_keys.push_back(a.m_keys[i]); result.m_values.push_back(a.m_values[i]); },
+				[&](size_t j) { result.m_keys.push_back(b.m_keys[j]); result.m_values.push_back(b.m_values[j]); },
+				mode);
+			return result;
+		}
+
+		/* Members */
+	private:
+		key_container_type m_keys; // Sorted by m_comp, no two equivalent.
+		mapped_container_type m_values; // Value of each key, at the same index.
+		Compare m_comp;
+
+	}; // !stack_flat_map<Key, T, N, Compare, Allocator> class
+
+} // !namespace sad
+#endif
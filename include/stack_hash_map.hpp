@@ -0,0 +1,482 @@
+#ifndef STACK_HASH_MAP_H
+#define STACK_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "stack_vector.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define SAD_HASH_SSE2 1
+#else
+	#define SAD_HASH_SSE2 0
+#endif
+
+// Stack Allocated Data
+namespace sad {
+
+	namespace detail {
+
+		// Slots probed together, one control word each.
+		constexpr std::size_t hash_group_width = 8;
+
+		// Slots for a table of n elements: a power of two at least n / (7 / 8), and one group at least.
+		constexpr std::size_t hash_slot_count(std::size_t n, std::size_t slots = hash_group_width)
+		{
+			return slots >= n + n / 7 + 1 ? slots : hash_slot_count(n, slots * 2);
+		}
+
+		// Spread the bits of a hash, std::hash of an integer often being the integer itself.
+		inline std::uint64_t hash_mix(std::uint64_t h) noexcept
+		{
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdull;
+			h ^= h >> 33;
+			return h;
+		}
+
+		// Lanes of a group as a bit mask, two bits per lane (the layout of _mm_movemask_epi8 over
+		// 16 bit lanes), only the low bit of each pair being used.
+		struct hash_lanes
+		{
+			std::uint32_t m_bits;
+
+			inline explicit operator bool() const noexcept { return m_bits != 0; }
+			inline unsigned lowest() const noexcept { return detail::countr_zero64(m_bits) / 2; }
+			inline void drop_lowest() noexcept { m_bits &= m_bits - 1; }
+		};
+
+		// Lanes of the group at control equal to word.
+		inline hash_lanes hash_match(const std::uint16_t* control, std::uint16_t word) noexcept
+		{
+		#if SAD_HASH_SSE2
+			const __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+			const __m128i equal = _mm_cmpeq_epi16(lanes, _mm_set1_epi16(static_cast<short>(word)));
+			return hash_lanes{ static_cast<std::uint32_t>(_mm_movemask_epi8(equal)) & 0x5555u };
+		#else
+			std::uint32_t bits = 0;
+			for (unsigned i = 0; i < hash_group_width; i++)
+				bits |= static_cast<std::uint32_t>(control[i] == word) << (2 * i);
+			return hash_lanes{ bits };
+		#endif
+		}
+
+		// Lanes of the group at control not written since the table's generation began.
+		inline hash_lanes hash_match_stale(const std::uint16_t* control, std::uint8_t generation) noexcept
+		{
+		#if SAD_HASH_SSE2
+			const __m128i lanes = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)), 8);
+			const __m128i current = _mm_cmpeq_epi16(lanes, _mm_set1_epi16(static_cast<short>(generation)));
+			return hash_lanes{ ~static_cast<std::uint32_t>(_mm_movemask_epi8(current)) & 0x5555u };
+		#else
+			std::uint32_t bits = 0;
+			for (unsigned i = 0; i < hash_group_width; i++)
+				bits |= static_cast<std::uint32_t>((control[i] >> 8) != generation) << (2 * i);
+			return hash_lanes{ bits };
+		#endif
+		}
+
+	} // !namespace detail
+
+
+	// Fixed-capacity hash map of up to N elements, stored inside the object like stack_vector<T, N>.
+	// Open addressing in the style of a Swiss table: every slot has a 16 bit control word holding
+	// the generation it was written in and 7 bits of its key's hash, and lookups compare a group of
+	// 8 control words at once (SSE2 where available) before touching any key.
+	// clear() only bumps the generation, which empties every slot in O(1) when K and V are trivially
+	// destructible. Erased slots are cleaned up in place by the insert that finds too many of them,
+	// which moves elements, so inserting invalidates iterators and references.
+	// Inserting past N throws std::length_error (or aborts without exceptions).
+	template<typename K, typename V, std::size_t N, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+	class stack_hash_map : private detail::inline_storage<std::pair<const K, V>, detail::hash_slot_count(N)>
+	{
+		static_assert(N > 0, "sad::stack_hash_map: N must be greater than 0");
+
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<const K, V>;
+		using ValueType = value_type;
+		using hasher = Hash;
+		using key_equal = KeyEqual;
+
+		// Number of slots, a power of two with room to spare so probes stay short.
+		static constexpr std::size_t slot_count = detail::hash_slot_count(N);
+
+		// Walks the live slots in slot order.
+		template<bool Const>
+		class basic_iterator
+		{
+		public:
+			using map_type = typename std::conditional<Const, const stack_hash_map, stack_hash_map>::type;
+
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = stack_hash_map::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = typename std::conditional<Const, const value_type*, value_type*>::type;
+			using reference = typename std::conditional<Const, const value_type&, value_type&>::type;
+
+		public:
+			inline basic_iterator() noexcept : m_map(nullptr), m_index(0) {}
+			inline basic_iterator(map_type* map, size_t index) noexcept : m_map(map), m_index(index) {}
+
+			// Any iterator converts to a const one.
+			template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+			inline basic_iterator(const basic_iterator<OtherConst>& other) noexcept : m_map(other.m_map), m_index(other.m_index) {}
+
+			_NODISCARD inline reference operator*() const noexcept { return m_map->_slot(m_index); }
+			_NODISCARD inline pointer operator->() const noexcept { return &m_map->_slot(m_index); }
+
+			inline basic_iterator& operator++() noexcept
+			{
+				m_index = m_map->_next_live(m_index + 1);
+				return *this;
+			}
+
+			inline basic_iterator operator++(int) noexcept
+			{
+				basic_iterator temp = *this;
+				++(*this);
+				return temp;
+			}
+
+			_NODISCARD inline bool operator==(const basic_iterator& rhs) const noexcept { return m_index == rhs.m_index; }
+			_NODISCARD inline bool operator!=(const basic_iterator& rhs) const noexcept { return m_index != rhs.m_index; }
+
+		private:
+			friend class stack_hash_map;
+
+			template<bool>
+			friend class basic_iterator;
+
+			map_type* m_map;
+			size_t m_index; // Live slot, or slot_count at the end.
+		};
+
+		using iterator = basic_iterator<false>;
+		using const_iterator = basic_iterator<true>;
+
+		/* Allocation / Deallocation */
+	public:
+		inline explicit stack_hash_map(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual()) : m_hash(hash), m_equal(equal)
+		{
+			std::memset(m_control, 0, sizeof(m_control));
+		}
+
+		inline stack_hash_map(const stack_hash_map& other) : stack_hash_map(other.m_hash, other.m_equal)
+		{
+			for (const value_type& entry : other)
+				this->try_emplace(entry.first, entry.second);
+		}
+
+		inline stack_hash_map& operator=(const stack_hash_map& rhs)
+		{
+			if (this != &rhs) {
+				this->clear();
+				m_hash = rhs.m_hash;
+				m_equal = rhs.m_equal;
+				for (const value_type& entry : rhs)
+					this->try_emplace(entry.first, entry.second);
+			}
+			return *this;
+		}
+
+		inline ~stack_hash_map()
+		{
+			this->_destroy_all();
+		}
+
+		/*----------------------------------------------------------*/
+		/*						   Modifiers						*/
+		/*----------------------------------------------------------*/
+
+		// Construct the value for key in place unless key is already there.
+		template<typename... Args>
+		inline std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+		{
+			const std::uint64_t hash = this->_hash(key);
+			size_t index = this->_find(key, hash);
+			if (index != slot_count)
+				return std::make_pair(iterator(this, index), false);
+
+			if (m_size == N)
+				detail::throw_length_error("sad::stack_hash_map: capacity exceeded");
+
+			// Misses only stop at a group with an unused slot, so once erased slots make up a third of
+			// the slots not in use, clean them up in place.
+			if (m_deleted * 2 >= slot_count - m_size - m_deleted)
+				this->_drop_deleted(std::integral_constant<bool, std::is_nothrow_move_constructible<value_type>::value>());
+
+			index = this->_free_slot(hash);
+			if (m_control[index] == this->_erased_word())
+				m_deleted--;
+			::new (static_cast<void*>(&this->_slot(index))) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+			m_control[index] = this->_word(hash);
+			m_size++;
+			return std::make_pair(iterator(this, index), true);
+		}
+
+		inline std::pair<iterator, bool> insert(const K& key, const V& value) { return this->try_emplace(key, value); }
+		inline std::pair<iterator, bool> insert(const value_type& entry) { return this->try_emplace(entry.first, entry.second); }
+
+		// Insert key, or overwrite its value if it is already there.
+		template<typename M>
+		inline std::pair<iterator, bool> insert_or_assign(const K& key, M&& value)
+		{
+			std::pair<iterator, bool> result = this->try_emplace(key, std::forward<M>(value));
+			if (!result.second)
+				result.first->second = std::forward<M>(value);
+			return result;
+		}
+
+		// Erase key, returning how many were erased (0 or 1).
+		inline size_t erase(const K& key)
+		{
+			const size_t index = this->_find(key, this->_hash(key));
+			if (index == slot_count)
+				return 0;
+
+			this->_erase_at(index);
+			return 1;
+		}
+
+		inline iterator erase(const_iterator position)
+		{
+			this->_erase_at(position.m_index);
+			return iterator(this, this->_next_live(position.m_index + 1));
+		}
+
+		// Empty the map. O(1) for trivially destructible keys and values, every old slot simply
+		// belonging to a past generation; otherwise the elements are destroyed first.
+		inline void clear() noexcept
+		{
+			this->_destroy_all();
+			m_size = 0;
+			m_deleted = 0;
+
+			// Every 255 clears the generation wraps, and the control words really have to be reset.
+			if (++m_generation == 0) {
+				std::memset(m_control, 0, sizeof(m_control));
+				m_generation = 1;
+			}
+		}
+
+		/*----------------------------------------------------------*/
+		/*						    Lookup							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline iterator find(const K& key) { return iterator(this, this->_find_or_end(key)); }
+		_NODISCARD inline const_iterator find(const K& key) const { return const_iterator(this, this->_find_or_end(key)); }
+
+		_NODISCARD inline bool contains(const K& key) const { return this->_find(key, this->_hash(key)) != slot_count; }
+		_NODISCARD inline size_t count(const K& key) const { return this->contains(key) ? 1 : 0; }
+
+		// Value of key, or nullptr if it isn't there.
+		_NODISCARD inline V* get(const K& key)
+		{
+			const size_t index = this->_find(key, this->_hash(key));
+			return index != slot_count ? &this->_slot(index).second : nullptr;
+		}
+
+		_NODISCARD inline const V* get(const K& key) const
+		{
+			const size_t index = this->_find(key, this->_hash(key));
+			return index != slot_count ? &this->_slot(index).second : nullptr;
+		}
+
+		/*----------------------------------------------------------*/
+		/*						Element access						*/
+		/*----------------------------------------------------------*/
+
+		// Value of key, default constructed first if it isn't there.
+		inline V& operator[](const K& key) { return this->try_emplace(key).first->second; }
+
+		/*----------------------------------------------------------*/
+		/*						Iterators							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline iterator begin() noexcept { return iterator(this, this->_next_live(0)); }
+		_NODISCARD inline iterator end() noexcept { return iterator(this, slot_count); }
+		_NODISCARD inline const_iterator begin() const noexcept { return const_iterator(this, this->_next_live(0)); }
+		_NODISCARD inline const_iterator end() const noexcept { return const_iterator(this, slot_count); }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline size_t size() const noexcept { return m_size; }
+		_NODISCARD inline bool empty() const noexcept { return m_size == 0; }
+		_NODISCARD static constexpr size_t capacity() noexcept { return N; }
+
+		_NODISCARD inline const Hash& hash_function() const noexcept { return m_hash; }
+		_NODISCARD inline const KeyEqual& key_eq() const noexcept { return m_equal; }
+
+		/* Helper Functions */
+	private:
+		static constexpr size_t group_count = slot_count / detail::hash_group_width;
+		static constexpr std::uint16_t deleted = 0x80; // Low byte of an erased slot, no 7 bit hash matches it.
+
+		inline value_type& _slot(size_t index) noexcept { return this->_inline_data()[index]; }
+		inline const value_type& _slot(size_t index) const noexcept { return this->_inline_data()[index]; }
+
+		inline std::uint64_t _hash(const K& key) const { return detail::hash_mix(static_cast<std::uint64_t>(m_hash(key))); }
+
+		// Control word of a live slot whose key hashes to hash.
+		inline std::uint16_t _word(std::uint64_t hash) const noexcept { return static_cast<std::uint16_t>((m_generation << 8) | (hash & 0x7F)); }
+
+		// Control word of a slot erased this generation.
+		inline std::uint16_t _erased_word() const noexcept { return static_cast<std::uint16_t>((m_generation << 8) | deleted); }
+
+		inline bool _live(size_t index) const noexcept
+		{
+			return (m_control[index] >> 8) == m_generation && (m_control[index] & 0xFF) != deleted;
+		}
+
+		// Slot of key, or slot_count. Groups are probed in triangular steps, which visits every
+		// group once since their count is a power of two.
+		inline size_t _find(const K& key, std::uint64_t hash) const
+		{
+			const std::uint16_t word = this->_word(hash);
+			size_t group = static_cast<size_t>(hash >> 7) & (group_count - 1);
+			for (size_t probe = 0; probe < group_count; probe++) {
+				const std::uint16_t* control = m_control + group * detail::hash_group_width;
+				for (detail::hash_lanes match = detail::hash_match(control, word); match; match.drop_lowest()) {
+					const size_t index = group * detail::hash_group_width + match.lowest();
+					if (m_equal(this->_slot(index).first, key))
+						return index;
+				}
+
+				// A slot never written this generation ends every probe sequence that would pass it.
+				if (detail::hash_match_stale(control, m_generation))
+					return slot_count;
+
+				group = (group + probe + 1) & (group_count - 1);
+			}
+			return slot_count;
+		}
+
+		inline size_t _find_or_end(const K& key) const { return this->_find(key, this->_hash(key)); }
+
+		// First erased or unused slot on the probe sequence of hash. There always is one, as the
+		// table has more slots than N.
+		inline size_t _free_slot(std::uint64_t hash) const noexcept
+		{
+			const std::uint16_t erased = this->_erased_word();
+			size_t group = static_cast<size_t>(hash >> 7) & (group_count - 1);
+			for (size_t probe = 0;; probe++) {
+				const std::uint16_t* control = m_control + group * detail::hash_group_width;
+				detail::hash_lanes free = detail::hash_match_stale(control, m_generation);
+				free.m_bits |= detail::hash_match(control, erased).m_bits;
+				if (free)
+					return group * detail::hash_group_width + free.lowest();
+
+				group = (group + probe + 1) & (group_count - 1);
+			}
+		}
+
+		// Leave a marker so probes for keys placed after this one keep going. A group that still
+		// has an unused slot has never been full this generation, so no probe ever went past it and
+		// the slot can simply become unused again.
+		inline void _erase_at(size_t index) noexcept
+		{
+			this->_slot(index).~value_type();
+			m_size--;
+
+			const std::uint16_t* control = m_control + (index - index % detail::hash_group_width);
+			if (detail::hash_match_stale(control, m_generation)) {
+				m_control[index] = 0;
+			}
+			else {
+				m_control[index] = this->_erased_word();
+				m_deleted++;
+			}
+		}
+
+		// Rehash in place, turning every erased slot back into an unused one (the way Swiss tables
+		// drop their tombstones without growing). Erased slots become unused, live ones are marked
+		// erased, then each marked element is moved to the first free slot on its probe sequence;
+		// one landing on another marked element swaps with it and carries on with that one.
+		// Elements that could throw while moving keep their erased slots until the next clear().
+		inline void _drop_deleted(std::false_type) noexcept {}
+
+		inline void _drop_deleted(std::true_type)
+		{
+			const std::uint16_t erased = this->_erased_word();
+			for (size_t i = 0; i < slot_count; i++) {
+				if (m_control[i] == erased)
+					m_control[i] = 0;
+				else if (this->_live(i))
+					m_control[i] = erased;
+			}
+
+			for (size_t i = 0; i < slot_count; i++) {
+				while (m_control[i] == erased) {
+					const std::uint64_t hash = this->_hash(this->_slot(i).first);
+					const size_t target = this->_free_slot(hash);
+
+					// Already in the first group with room on its probe sequence.
+					if (target / detail::hash_group_width == i / detail::hash_group_width) {
+						m_control[i] = this->_word(hash);
+						break;
+					}
+
+					if (m_control[target] != erased) {
+						::new (static_cast<void*>(&this->_slot(target))) value_type(std::move(this->_slot(i)));
+						this->_slot(i).~value_type();
+						m_control[target] = this->_word(hash);
+						m_control[i] = 0;
+						break;
+					}
+
+					value_type temp(std::move(this->_slot(target)));
+					this->_slot(target).~value_type();
+					::new (static_cast<void*>(&this->_slot(target))) value_type(std::move(this->_slot(i)));
+					this->_slot(i).~value_type();
+					::new (static_cast<void*>(&this->_slot(i))) value_type(std::move(temp));
+					m_control[target] = this->_word(hash);
+				}
+			}
+			m_deleted = 0;
+		}
+
+		// First live slot from index on, or slot_count.
+		inline size_t _next_live(size_t index) const noexcept
+		{
+			while (index < slot_count && !this->_live(index))
+				index++;
+			return index;
+		}
+
+		inline void _destroy_all() noexcept
+		{
+			if (std::is_trivially_destructible<value_type>::value || m_size == 0)
+				return;
+
+			for (size_t i = this->_next_live(0); i < slot_count; i = this->_next_live(i + 1))
+				this->_slot(i).~value_type();
+		}
+
+		/* Members */
+	private:
+		std::uint16_t m_control[slot_count]; // Generation << 8 | 7 bits of hash, or deleted.
+		size_t m_size = 0;
+		size_t m_deleted = 0; // Slots erased this generation and not reused yet.
+		std::uint8_t m_generation = 1; // Slots of any other generation are unused; 0 is never current.
+		Hash m_hash;
+		KeyEqual m_equal;
+
+	}; // !stack_hash_map<K, V, N, Hash, KeyEqual> class
+
+	template<typename K, typename V, std::size_t N, typename Hash, typename KeyEqual>
+	constexpr std::size_t stack_hash_map<K, V, N, Hash, KeyEqual>::slot_count;
+
+} // !namespace sad
+#endif
@@ -0,0 +1,254 @@
+#ifndef STACK_RING_H
+#define STACK_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "stack_vector.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	// How a stack_ring synchronises its two ends.
+	namespace ring {
+
+		// One producer thread and one consumer thread, lock-free. Each end's index sits on its own
+		// cache line and is published with release and read with acquire.
+		struct spsc {};
+
+		// Both ends on the same thread, the indices are plain integers.
+		struct single_thread {};
+
+	} // !namespace ring
+
+	namespace detail {
+
+		// One end of a ring: its own position, plus the last position of the other end it has seen
+		// so it only has to read the other end's cache line when it seems to have caught up.
+		template<typename Sync>
+		struct ring_end;
+
+		template<>
+		struct alignas(SAD_CACHE_LINE) ring_end<ring::spsc>
+		{
+			inline size_t _own() const noexcept { return m_position.load(std::memory_order_relaxed); }
+			inline size_t _acquire() const noexcept { return m_position.load(std::memory_order_acquire); }
+			inline void _publish(size_t position) noexcept { m_position.store(position, std::memory_order_release); }
+
+			std::atomic<size_t> m_position{ 0 }; // Elements pushed, or popped, so far.
+			size_t m_seen = 0; // Position of the other end when last read.
+		};
+
+		template<>
+		struct ring_end<ring::single_thread>
+		{
+			inline size_t _own() const noexcept { return m_position; }
+			inline size_t _acquire() const noexcept { return m_position; }
+			inline void _publish(size_t position) noexcept { m_position = position; }
+
+			size_t m_position = 0; // Elements pushed, or popped, so far.
+			size_t m_seen = 0; // Position of the other end when last read.
+		};
+
+	} // !namespace detail
+
+
+	// Fixed-capacity circular buffer of N elements stored inside the object, like stack_vector<T, N>.
+	// With ring::spsc (the default) one thread may push while another pops without any lock; the
+	// push functions are the producer's, the pop functions (and peek, clear) the consumer's.
+	// Nothing is ever allocated, a push into a full ring or a pop from an empty one just fails.
+	template<typename T, std::size_t N, typename Sync = ring::spsc>
+	class stack_ring : private detail::inline_storage<T, N>
+	{
+		static_assert(N > 0, "sad::stack_ring: N must be greater than 0");
+
+	public:
+		using ValueType = T;
+		using sync_type = Sync;
+
+		/* Allocation / Deallocation */
+	public:
+		stack_ring() = default;
+
+		inline ~stack_ring()
+		{
+			this->clear();
+		}
+
+		stack_ring(const stack_ring&) = delete;
+		stack_ring& operator=(const stack_ring&) = delete;
+
+		/*----------------------------------------------------------*/
+		/*						   Producer							*/
+		/*----------------------------------------------------------*/
+
+		// Construct an element at the back, false if the ring is full.
+		template<typename... Args>
+		inline bool try_emplace(Args&&... args)
+		{
+			const size_t head = m_head._own();
+			if (this->_free(head, 1) == 0)
+				return false;
+
+			::new (static_cast<void*>(this->_slot(head))) T(std::forward<Args>(args)...);
+			m_head._publish(head + 1);
+			return true;
+		}
+
+		inline bool try_push(const T& value) { return this->try_emplace(value); }
+		inline bool try_push(T&& value) { return this->try_emplace(std::move(value)); }
+
+		// Copy as many of the count elements at src as fit, publishing them all at once.
+		// Returns how many were pushed.
+		inline size_t push_n(const T* src, size_t count)
+		{
+			const size_t head = m_head._own();
+			count = std::min(count, this->_free(head, count));
+			if (count == 0)
+				return 0;
+
+			// Publishes whatever was constructed, even if a copy throws half way.
+			size_t pushed = 0;
+			publish_guard guard{ m_head, head, pushed };
+
+			const size_t start = head % N;
+			const size_t first = std::min(count, N - start);
+			if (std::is_trivially_copyable<T>::value) {
+				std::memcpy(static_cast<void*>(this->_inline_data() + start), src, first * sizeof(T));
+				std::memcpy(static_cast<void*>(this->_inline_data()), src + first, (count - first) * sizeof(T));
+				pushed = count;
+			}
+			else {
+				for (; pushed < count; pushed++)
+					::new (static_cast<void*>(this->_slot(head + pushed))) T(src[pushed]);
+			}
+			return pushed;
+		}
+
+		/*----------------------------------------------------------*/
+		/*						   Consumer							*/
+		/*----------------------------------------------------------*/
+
+		// Move the front element into out, false if the ring is empty.
+		inline bool try_pop(T& out)
+		{
+			const size_t tail = m_tail._own();
+			if (this->_available(tail, 1) == 0)
+				return false;
+
+			T* slot = this->_slot(tail);
+			out = std::move(*slot);
+			slot->~T();
+			m_tail._publish(tail + 1);
+			return true;
+		}
+
+		// Move up to count elements from the front into dst, freeing their slots all at once.
+		// Returns how many were popped.
+		inline size_t pop_n(T* dst, size_t count)
+		{
+			const size_t tail = m_tail._own();
+			count = std::min(count, this->_available(tail, count));
+			if (count == 0)
+				return 0;
+
+			// Frees whatever was destroyed, even if a move throws half way, so no slot is destroyed twice.
+			size_t popped = 0;
+			publish_guard guard{ m_tail, tail, popped };
+
+			const size_t start = tail % N;
+			const size_t first = std::min(count, N - start);
+			if (std::is_trivially_copyable<T>::value) {
+				std::memcpy(static_cast<void*>(dst), this->_inline_data() + start, first * sizeof(T));
+				std::memcpy(static_cast<void*>(dst + first), this->_inline_data(), (count - first) * sizeof(T));
+				popped = count;
+			}
+			else {
+				for (; popped < count; popped++) {
+					T* slot = this->_slot(tail + popped);
+					dst[popped] = std::move(*slot);
+					slot->~T();
+				}
+			}
+			return popped;
+		}
+
+		// Front element, or nullptr if the ring is empty. Stays valid until it is popped.
+		_NODISCARD inline T* peek() noexcept
+		{
+			const size_t tail = m_tail._own();
+			return this->_available(tail, 1) > 0 ? this->_slot(tail) : nullptr;
+		}
+
+		// Destroy every element pushed so far.
+		inline void clear() noexcept
+		{
+			const size_t tail = m_tail._own();
+			const size_t head = m_head._acquire();
+			for (size_t i = tail; i != head; i++)
+				this->_slot(i)->~T();
+			m_tail.m_seen = head; // Never behind the tail, or the ring would seem to hold elements.
+			m_tail._publish(head);
+		}
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity							*/
+		/*----------------------------------------------------------*/
+
+		// Number of elements, only a snapshot while the other end is busy.
+		_NODISCARD inline size_t size() const noexcept
+		{
+			const size_t tail = m_tail._acquire();
+			return m_head._acquire() - tail;
+		}
+
+		_NODISCARD inline bool empty() const noexcept { return this->size() == 0; }
+		_NODISCARD inline bool full() const noexcept { return this->size() == N; }
+		_NODISCARD static constexpr size_t capacity() noexcept { return N; }
+
+		/* Helper Functions */
+	private:
+		// Publishes start + count to one end of the ring when it goes out of scope, so a batch that
+		// throws half way still hands over the elements it got through.
+		struct publish_guard
+		{
+			detail::ring_end<Sync>& m_end;
+			const size_t m_start;
+			const size_t& m_count;
+			inline ~publish_guard() { if (m_count > 0) m_end._publish(m_start + m_count); }
+		};
+
+		inline T* _slot(size_t position) noexcept { return this->_inline_data() + position % N; }
+
+		// Slots the producer can fill, only reading the consumer's index when the last one seen
+		// leaves fewer than wanted.
+		inline size_t _free(size_t head, size_t wanted) noexcept
+		{
+			if (N - (head - m_head.m_seen) < wanted)
+				m_head.m_seen = m_tail._acquire();
+			return N - (head - m_head.m_seen);
+		}
+
+		// Elements the consumer can take, only reading the producer's index when the last one seen
+		// leaves fewer than wanted.
+		inline size_t _available(size_t tail, size_t wanted) noexcept
+		{
+			if (m_tail.m_seen - tail < wanted)
+				m_tail.m_seen = m_head._acquire();
+			return m_tail.m_seen - tail;
+		}
+
+		/* Members */
+	private:
+		detail::ring_end<Sync> m_head; // Written by the producer.
+		detail::ring_end<Sync> m_tail; // Written by the consumer.
+
+	}; // !stack_ring<T, N, Sync> class
+
+} // !namespace sad
+#endif
@@ -0,0 +1,210 @@
+#ifndef STACK_SLOT_MAP_H
+#define STACK_SLOT_MAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "span.hpp"
+#include "stack_vector.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	// Stable reference to an element of a stack_slot_map. Stays valid (and keeps referring to the
+	// same element) until that element is erased, after which the map rejects it.
+	struct slot_handle
+	{
+		std::uint32_t index = 0; // Slot in the sparse array.
+		std::uint32_t generation = 0; // Generation of the slot when the element was inserted, 0 for no element.
+
+		_NODISCARD inline bool operator==(const slot_handle& rhs) const noexcept { return index == rhs.index && generation == rhs.generation; }
+		_NODISCARD inline bool operator!=(const slot_handle& rhs) const noexcept { return !(*this == rhs); }
+	};
+
+	// Pool of up to N elements addressed through slot_handles, stored inside the object.
+	// The elements are kept packed in a stack_vector<T, N>, so iterating them is a plain array walk;
+	// a sparse array of slots maps each handle to its element's current position. Insert and erase
+	// are O(1): erasing moves the last element into the hole and repoints its slot, and bumps the
+	// erased slot's generation so handles to the old element stop resolving.
+	template<typename T, std::size_t N>
+	class stack_slot_map
+	{
+		static_assert(N > 0, "sad::stack_slot_map: N must be greater than 0");
+		static_assert(N < 0xFFFFFFFFu, "sad::stack_slot_map: N must fit in a 32 bit index");
+
+	public:
+		using ValueType = T;
+		using handle = slot_handle;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		/* Allocation / Deallocation */
+	public:
+		stack_slot_map() = default;
+
+		/*----------------------------------------------------------*/
+		/*						   Modifiers						*/
+		/*----------------------------------------------------------*/
+
+		// Construct an element and return its handle. Throws std::length_error (or aborts without
+		// exceptions) once N elements are in the map.
+		template<typename... Args>
+		inline handle emplace(Args&&... args)
+		{
+			if (m_values.size() == N)
+				detail::throw_length_error("sad::stack_slot_map: capacity exceeded");
+
+			// Construct first, so a throwing constructor leaves the map untouched.
+			m_values.emplace_back(std::forward<Args>(args)...);
+
+			const std::uint32_t index = this->_take_slot();
+			slot& s = m_slots[index];
+			s.m_dense = static_cast<std::uint32_t>(m_values.size() - 1);
+			m_dense_to_slot.push_back(index);
+
+			handle h;
+			h.index = index;
+			h.generation = s.m_generation;
+			return h;
+		}
+
+		inline handle insert(const T& value) { return this->emplace(value); }
+		inline handle insert(T&& value) { return this->emplace(std::move(value)); }
+
+		// Erase the element of h, moving the last element into its place. False if h is stale.
+		inline bool erase(handle h)
+		{
+			if (!this->contains(h))
+				return false;
+
+			slot& s = m_slots[h.index];
+			const std::uint32_t dense = s.m_dense;
+			const std::uint32_t last = static_cast<std::uint32_t>(m_values.size() - 1);
+			if (dense != last) {
+				m_values[dense] = std::move(m_values[last]);
+				m_dense_to_slot[dense] = m_dense_to_slot[last];
+				m_slots[m_dense_to_slot[dense]].m_dense = dense;
+			}
+			m_values.pop_back();
+			m_dense_to_slot.pop_back();
+
+			this->_free_slot(h.index);
+			return true;
+		}
+
+		// Erase every element, invalidating every handle.
+		inline void clear() noexcept
+		{
+			for (size_t i = 0; i < m_dense_to_slot.size(); i++)
+				this->_free_slot(m_dense_to_slot[i]);
+			m_values.clear();
+			m_dense_to_slot.clear();
+		}
+
+		/*----------------------------------------------------------*/
+		/*						    Lookup							*/
+		/*----------------------------------------------------------*/
+
+		// Check if h still refers to an element of this map.
+		_NODISCARD inline bool contains(handle h) const noexcept
+		{
+			return h.index < m_used_slots && h.generation != 0 && m_slots[h.index].m_generation == h.generation;
+		}
+
+		// Element of h, or nullptr if it was erased.
+		_NODISCARD inline T* get(handle h) noexcept { return this->contains(h) ? &m_values[m_slots[h.index].m_dense] : nullptr; }
+		_NODISCARD inline const T* get(handle h) const noexcept { return this->contains(h) ? &m_values[m_slots[h.index].m_dense] : nullptr; }
+
+		_NODISCARD inline T& operator[](handle h) noexcept
+		{
+			assert(this->contains(h));
+			return m_values[m_slots[h.index].m_dense];
+		}
+
+		_NODISCARD inline const T& operator[](handle h) const noexcept
+		{
+			assert(this->contains(h));
+			return m_values[m_slots[h.index].m_dense];
+		}
+
+		// Handle of the element at position index of the packed array.
+		_NODISCARD inline handle handle_at(size_t index) const noexcept
+		{
+			assert(index < m_values.size());
+			handle h;
+			h.index = m_dense_to_slot[index];
+			h.generation = m_slots[h.index].m_generation;
+			return h;
+		}
+
+		/*----------------------------------------------------------*/
+		/*					  Packed element access					*/
+		/*----------------------------------------------------------*/
+
+		// Elements in no particular order, moved around by erase.
+		_NODISCARD inline T* data() noexcept { return m_values.data(); }
+		_NODISCARD inline const T* data() const noexcept { return m_values.data(); }
+		_NODISCARD inline span<T> values() noexcept { return span<T>(m_values.data(), m_values.size()); }
+		_NODISCARD inline span<const T> values() const noexcept { return span<const T>(m_values.data(), m_values.size()); }
+
+		_NODISCARD inline iterator begin() noexcept { return m_values.data(); }
+		_NODISCARD inline iterator end() noexcept { return m_values.data() + m_values.size(); }
+		_NODISCARD inline const_iterator begin() const noexcept { return m_values.data(); }
+		_NODISCARD inline const_iterator end() const noexcept { return m_values.data() + m_values.size(); }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline size_t size() const noexcept { return m_values.size(); }
+		_NODISCARD inline bool empty() const noexcept { return m_values.size() == 0; }
+		_NODISCARD static constexpr size_t capacity() noexcept { return N; }
+
+		/* Helper Functions */
+	private:
+		static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+		// Where a handle points: its element while the slot is in use, the next free slot otherwise.
+		struct slot
+		{
+			std::uint32_t m_dense; // Position of the element, or the next free slot.
+			std::uint32_t m_generation; // Bumped on every erase, never 0.
+		};
+
+		// Reuse a free slot, or start using a new one.
+		inline std::uint32_t _take_slot() noexcept
+		{
+			if (m_free != npos) {
+				const std::uint32_t index = m_free;
+				m_free = m_slots[index].m_dense;
+				return index;
+			}
+
+			const std::uint32_t index = m_used_slots++;
+			m_slots[index].m_generation = 1;
+			return index;
+		}
+
+		inline void _free_slot(std::uint32_t index) noexcept
+		{
+			slot& s = m_slots[index];
+			if (++s.m_generation == 0)
+				s.m_generation = 1;
+			s.m_dense = m_free;
+			m_free = index;
+		}
+
+		/* Members */
+	private:
+		stack_vector<T, N> m_values; // Packed elements.
+		stack_vector<std::uint32_t, N> m_dense_to_slot; // Slot of each packed element.
+		slot m_slots[N]; // Only the first m_used_slots are initialised.
+		std::uint32_t m_used_slots = 0; // Slots handed out at least once.
+		std::uint32_t m_free = npos; // Head of the list of free slots.
+
+	}; // !stack_slot_map<T, N> class
+
+} // !namespace sad
+#endif
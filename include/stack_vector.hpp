@@ -15,10 +15,289 @@
 
 #include <initializer_list>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "config.hpp"
+#include "instrumentation.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	#include <intrin.h>
+#endif
+
+// Size of a cache line, what data written by different threads is padded and aligned to so that
+// no two threads ever write to the same line.
+#ifndef SAD_CACHE_LINE
+	#define SAD_CACHE_LINE 64
+#endif
 
 // Stack Allocated Data
 namespace sad {
 
+	// Non-owning view of contiguous elements, see span.hpp.
+	template<typename T>
+	class span;
+
+	// Types that can be moved to a new address with a plain memcpy, leaving nothing to destroy at
+	// the old one. True for trivially copyable types; specialise it for your own types that qualify
+	// (no self pointers, no registration of their own address), e.g.
+	//     template<> struct sad::is_trivially_relocatable<float3> : std::true_type {};
+	template<typename T>
+	struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+	// Types for which a == b exactly when their bytes are equal, so whole arrays can be compared
+	// with memcmp. True for integers, enums and pointers (not floats, as -0.0 == 0.0 and NaN != NaN);
+	// specialise it for your own types without padding that compare member by member.
+	template<typename T>
+	struct is_trivially_comparable : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value> {};
+
+	namespace detail {
+
+		// Called when a fixed-capacity vector is asked to hold more than it can.
+		[[noreturn]] inline void throw_length_error(const char* what)
+		{
+			#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+				throw std::length_error(what);
+			#else
+				(void)what;
+				std::abort();
+			#endif
+		}
+
+		// Called when an allocator runs out of memory to hand out.
+		[[noreturn]] inline void throw_bad_alloc()
+		{
+			#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+				throw std::bad_alloc();
+			#else
+				std::abort();
+			#endif
+		}
+
+		// Number of set bits in a word.
+		inline unsigned popcount64(std::uint64_t word) noexcept
+		{
+		#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<unsigned>(__builtin_popcountll(word));
+		#elif defined(_MSC_VER) && defined(_M_X64) && defined(__AVX__) // POPCNT is guaranteed alongside AVX.
+			return static_cast<unsigned>(__popcnt64(word));
+		#else
+			word = word - ((word >> 1) & 0x5555555555555555ull);
+			word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+			word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+			return static_cast<unsigned>((word * 0x0101010101010101ull) >> 56);
+		#endif
+		}
+
+		// Index of the lowest set bit of a non-zero word.
+		inline unsigned countr_zero64(std::uint64_t word) noexcept
+		{
+			assert(word != 0);
+		#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<unsigned>(__builtin_ctzll(word));
+		#elif defined(_MSC_VER) && defined(_M_X64)
+			unsigned long index;
+			_BitScanForward64(&index, word);
+			return static_cast<unsigned>(index);
+		#else
+			return popcount64((word & (~word + 1)) - 1);
+		#endif
+		}
+
+		// Raw, suitably aligned space for N elements of T, embedded in the owning object.
+		template<typename T, std::size_t N, bool = SAD_CONSTEXPR_VECTOR && (N > 0) && std::is_trivial<T>::value>
+		struct inline_storage
+		{
+			inline T* _inline_data() noexcept { return reinterpret_cast<T*>(&m_buffer); }
+			inline const T* _inline_data() const noexcept { return reinterpret_cast<const T*>(&m_buffer); }
+
+			typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type m_buffer;
+		};
+
+		// A real array for trivial types when constexpr is on, constant evaluation can't cast raw
+		// storage. Left uninitialised at run time, zeroed when constant evaluated since a
+		// constexpr variable can't hold indeterminate values.
+		template<typename T, std::size_t N>
+		struct inline_storage<T, N, true>
+		{
+			SAD_CONSTEXPR inline inline_storage() noexcept
+			{
+				if (SAD_IS_CONSTANT_EVALUATED()) {
+					for (std::size_t i = 0; i < N; i++)
+						m_buffer[i] = T();
+				}
+			}
+
+			SAD_CONSTEXPR inline T* _inline_data() noexcept { return m_buffer; }
+			SAD_CONSTEXPR inline const T* _inline_data() const noexcept { return m_buffer; }
+
+			T m_buffer[N];
+		};
+
+		// No inline space, the vector allocates its buffer in _reallocate.
+		template<typename T>
+		struct inline_storage<T, 0>
+		{
+			SAD_CONSTEXPR inline T* _inline_data() noexcept { return nullptr; }
+			SAD_CONSTEXPR inline const T* _inline_data() const noexcept { return nullptr; }
+		};
+
+		// Where a vector's buffer comes from once it outgrows its inline storage.
+		struct inline_only_tag {}; // Nowhere, N is a hard limit.
+		struct allocator_tag {}; // The Allocator template argument, std::allocator when it is void and N is 0.
+
+		template<std::size_t N, typename Allocator>
+		struct storage_category { using type = allocator_tag; };
+
+		template<std::size_t N>
+		struct storage_category<N, void> { using type = typename std::conditional<(N > 0), inline_only_tag, allocator_tag>::type; };
+
+		// Allocator used for Allocator, rebound to T, std::allocator<T> standing in for void.
+		template<typename T, typename Allocator>
+		struct allocator_for { using type = typename std::allocator_traits<Allocator>::template rebind_alloc<T>; };
+
+		template<typename T>
+		struct allocator_for<T, void> { using type = std::allocator<T>; };
+
+		// Keeps the allocator, without spending any space on it when it is stateless.
+		template<typename Allocator, bool = std::is_empty<Allocator>::value>
+		struct allocator_holder : private Allocator
+		{
+			allocator_holder() = default;
+			SAD_CONSTEXPR allocator_holder(const Allocator& allocator) : Allocator(allocator) {}
+
+			SAD_CONSTEXPR inline Allocator& _allocator() noexcept { return *this; }
+			SAD_CONSTEXPR inline const Allocator& _allocator() const noexcept { return *this; }
+		};
+
+		template<typename Allocator>
+		struct allocator_holder<Allocator, false>
+		{
+			allocator_holder() = default;
+			SAD_CONSTEXPR allocator_holder(const Allocator& allocator) : m_allocator(allocator) {}
+
+			SAD_CONSTEXPR inline Allocator& _allocator() noexcept { return m_allocator; }
+			SAD_CONSTEXPR inline const Allocator& _allocator() const noexcept { return m_allocator; }
+
+			Allocator m_allocator;
+		};
+
+		// Keeps the growth policy, without spending any space on it when it is stateless.
+		template<typename Growth, bool = std::is_empty<Growth>::value>
+		struct growth_holder : private Growth
+		{
+			growth_holder() = default;
+			SAD_CONSTEXPR growth_holder(const Growth& growth) : Growth(growth) {}
+
+			SAD_CONSTEXPR inline Growth& _growth() noexcept { return *this; }
+			SAD_CONSTEXPR inline const Growth& _growth() const noexcept { return *this; }
+		};
+
+		template<typename Growth>
+		struct growth_holder<Growth, false>
+		{
+			growth_holder() = default;
+			SAD_CONSTEXPR growth_holder(const Growth& growth) : m_growth(growth) {}
+
+			SAD_CONSTEXPR inline Growth& _growth() noexcept { return m_growth; }
+			SAD_CONSTEXPR inline const Growth& _growth() const noexcept { return m_growth; }
+
+			Growth m_growth;
+		};
+
+		// begin()/end() of a range, found through ADL like in a range-based for loop.
+		using std::begin;
+		using std::end;
+
+		template<typename Range>
+		SAD_CONSTEXPR inline auto range_begin(Range& range) -> decltype(begin(range)) { return begin(range); }
+
+		template<typename Range>
+		SAD_CONSTEXPR inline auto range_end(Range& range) -> decltype(end(range)) { return end(range); }
+
+		// Detects allocators that can grow their most recent block in place, see stack_arena.hpp.
+		template<typename Allocator, typename T, typename = void>
+		struct has_try_extend : std::false_type {};
+
+		template<typename Allocator, typename T>
+		struct has_try_extend<Allocator, T, decltype(void(std::declval<Allocator&>().try_extend(std::declval<T*>(), std::size_t(), std::size_t())))> : std::true_type {};
+
+		// Index of the first element where a and b differ, or n.
+		template<typename T>
+		SAD_CONSTEXPR inline size_t mismatch(const T* a, const T* b, const size_t n, std::true_type) noexcept
+		{
+			// Fixed size memcmp's of a cache line compile down to a few vector compares.
+			const size_t block = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+			size_t i = 0;
+			for (; i + block <= n && !SAD_IS_CONSTANT_EVALUATED(); i += block) {
+				if (std::memcmp(a + i, b + i, block * sizeof(T)) != 0)
+					break;
+			}
+
+			for (; i < n; ++i) {
+				if (!(a[i] == b[i]))
+					return i;
+			}
+			return n;
+		}
+
+		// Check if n elements of a and b are equal, stopping at the first difference.
+		template<typename T>
+		SAD_CONSTEXPR inline bool equal(const T* a, const T* b, const size_t n, std::false_type)
+		{
+			for (size_t i = 0; i < n; ++i) {
+				if (!(a[i] == b[i]))
+					return false;
+			}
+			return true;
+		}
+
+		template<typename T>
+		SAD_CONSTEXPR inline bool equal(const T* a, const T* b, const size_t n, std::true_type) noexcept
+		{
+			if (SAD_IS_CONSTANT_EVALUATED())
+				return detail::equal(a, b, n, std::false_type());
+			return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+		}
+
+		// Lexicographic three-way comparison, negative when a comes first, 0 when equal, positive after.
+		template<typename T>
+		SAD_CONSTEXPR inline int compare(const T* a, const size_t a_size, const T* b, const size_t b_size, std::true_type) noexcept
+		{
+			const size_t n = a_size < b_size ? a_size : b_size;
+			const size_t i = detail::mismatch(a, b, n, std::true_type());
+			if (i < n)
+				return a[i] < b[i] ? -1 : 1;
+			return a_size < b_size ? -1 : (a_size > b_size ? 1 : 0);
+		}
+
+		// Only needs operator<, like std::lexicographical_compare.
+		template<typename T>
+		SAD_CONSTEXPR inline int compare(const T* a, const size_t a_size, const T* b, const size_t b_size, std::false_type)
+		{
+			const size_t n = a_size < b_size ? a_size : b_size;
+			for (size_t i = 0; i < n; ++i) {
+				if (a[i] < b[i])
+					return -1;
+				if (b[i] < a[i])
+					return 1;
+			}
+			return a_size < b_size ? -1 : (a_size > b_size ? 1 : 0);
+		}
+
+	} // !namespace detail
+
 	// Constant iterator
 	template<typename stack_vector>
 	class const_iterator {
@@ -27,33 +306,39 @@ namespace sad {
 		using PointerType = ValueType*;
 		using ReferenceType = ValueType&;
 
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = ValueType;
+		using difference_type = std::ptrdiff_t;
+		using pointer = PointerType;
+		using reference = ReferenceType;
+
 	public:
-		inline const_iterator() noexcept : m_ptr() {}
-		inline const_iterator(PointerType ptr) noexcept : m_ptr(ptr) { }
+		SAD_CONSTEXPR inline const_iterator() noexcept : m_ptr() {}
+		SAD_CONSTEXPR inline const_iterator(PointerType ptr) noexcept : m_ptr(ptr) { }
 
-		_NODISCARD inline ReferenceType operator[](const size_t index) const noexcept { return *(m_ptr[index]); }
-		_NODISCARD inline PointerType operator->() const noexcept { return m_ptr; }
-		_NODISCARD inline ReferenceType operator*() const noexcept { return *m_ptr; }
+		_NODISCARD SAD_CONSTEXPR inline ReferenceType operator[](const size_t index) const noexcept { return m_ptr[index]; }
+		_NODISCARD SAD_CONSTEXPR inline PointerType operator->() const noexcept { return m_ptr; }
+		_NODISCARD SAD_CONSTEXPR inline ReferenceType operator*() const noexcept { return *m_ptr; }
 
 		/* Increment / Decrement */
 
-		inline const_iterator& operator++() noexcept
+		SAD_CONSTEXPR inline const_iterator& operator++() noexcept
 		{
 			m_ptr++;
 			return *this;
 		}
-		inline const_iterator operator++(int) noexcept
+		SAD_CONSTEXPR inline const_iterator operator++(int) noexcept
 		{
 			const_iterator temp = *this;
 			++(*this);
 			return temp;
 		}
-		inline const_iterator& operator--() noexcept
+		SAD_CONSTEXPR inline const_iterator& operator--() noexcept
 		{
 			m_ptr--;
 			return *this;
 		}
-		inline const_iterator operator--(int) noexcept
+		SAD_CONSTEXPR inline const_iterator operator--(int) noexcept
 		{
 			const_iterator temp = *this;
 			--(*this);
@@ -62,60 +347,66 @@ namespace sad {
 
 		/* Addition / Subtraction */
 
-		inline const_iterator& operator+=(const size_t val) noexcept
+		SAD_CONSTEXPR inline const_iterator& operator+=(const difference_type val) noexcept
 		{
 			m_ptr += val;
 			return *this;
 		}
 
-		_NODISCARD inline const_iterator operator+(const size_t val) const noexcept
+		_NODISCARD SAD_CONSTEXPR inline const_iterator operator+(const difference_type val) const noexcept
 		{
 			const_iterator temp = *this;
 			temp += val;
 			return temp;
 		}
 
-		inline const_iterator& operator-=(const size_t val) noexcept
+		SAD_CONSTEXPR inline const_iterator& operator-=(const difference_type val) noexcept
 		{
 			m_ptr -= val;
 			return *this;
 		}
 
-		_NODISCARD inline const_iterator operator-(const size_t val) const noexcept
+		_NODISCARD SAD_CONSTEXPR inline const_iterator operator-(const difference_type val) const noexcept
 		{
 			const_iterator temp = *this;
 			temp -= val;
 			return temp;
 		}
 
+		// Distance between two iterators.
+		_NODISCARD SAD_CONSTEXPR inline difference_type operator-(const const_iterator& other) const noexcept
+		{
+			return m_ptr - other.m_ptr;
+		}
+
 		/* RELATIONAL OPERATORS */
 
-		bool operator==(const const_iterator& other) const noexcept
+		SAD_CONSTEXPR bool operator==(const const_iterator& other) const noexcept
 		{
 			return m_ptr == other.m_ptr;
 		}
 
-		bool operator!=(const const_iterator& other) const noexcept
+		SAD_CONSTEXPR bool operator!=(const const_iterator& other) const noexcept
 		{
 			return !(*this == other);
 		}
 
-		bool operator>=(const const_iterator& other) const noexcept
+		SAD_CONSTEXPR bool operator>=(const const_iterator& other) const noexcept
 		{
 			return m_ptr >= other.m_ptr;
 		}
 
-		bool operator<=(const const_iterator& other) const noexcept
+		SAD_CONSTEXPR bool operator<=(const const_iterator& other) const noexcept
 		{
 			return m_ptr <= other.m_ptr;
 		}
 
-		bool operator>(const const_iterator& other) const noexcept
+		SAD_CONSTEXPR bool operator>(const const_iterator& other) const noexcept
 		{
 			return m_ptr > other.m_ptr;
 		}
 
-		bool operator<(const const_iterator& other) const noexcept
+		SAD_CONSTEXPR bool operator<(const const_iterator& other) const noexcept
 		{
 			return m_ptr < other.m_ptr;
 		}
@@ -133,96 +424,103 @@ namespace sad {
 		using ValueType = typename stack_vector::ValueType;
 		using PointerType = ValueType*;
 		using ReferenceType = ValueType&;
+		using difference_type = std::ptrdiff_t;
 	public:
-		iterator() { this->m_ptr = nullptr; }
-		iterator(PointerType ptr) { this->m_ptr = ptr; }
+		SAD_CONSTEXPR iterator() { this->m_ptr = nullptr; }
+		SAD_CONSTEXPR iterator(PointerType ptr) { this->m_ptr = ptr; }
 
-		ReferenceType operator[](const size_t index) const noexcept { return *(this->m_ptr[index]); }
-		PointerType operator->() { return this->m_ptr; }
-		ReferenceType operator*() { return *this->m_ptr; }
+		SAD_CONSTEXPR ReferenceType operator[](const size_t index) const noexcept { return this->m_ptr[index]; }
+		SAD_CONSTEXPR PointerType operator->() { return this->m_ptr; }
+		SAD_CONSTEXPR ReferenceType operator*() { return *this->m_ptr; }
 
 		/* Addition / Subtraction */
 
-		inline iterator& operator++() noexcept
+		SAD_CONSTEXPR inline iterator& operator++() noexcept
 		{
 			this->m_ptr++;
 			return *this;
 		}
 
-		inline iterator operator++(int) noexcept
+		SAD_CONSTEXPR inline iterator operator++(int) noexcept
 		{
 			iterator temp = *this;
 			++(*this);
 			return temp;
 		}
 
-		inline iterator& operator--() noexcept
+		SAD_CONSTEXPR inline iterator& operator--() noexcept
 		{
 			this->m_ptr--;
 			return *this;
 		}
 
-		inline iterator operator--(int) noexcept
+		SAD_CONSTEXPR inline iterator operator--(int) noexcept
 		{
 			iterator temp = *this;
 			--(*this);
 			return temp;
 		}
 
-		inline iterator& operator+=(const size_t val) noexcept
+		SAD_CONSTEXPR inline iterator& operator+=(const difference_type val) noexcept
 		{
 			this->m_ptr += val;
 			return *this;
 		}
 
-		_NODISCARD inline iterator& operator+(const size_t val) const noexcept
+		_NODISCARD SAD_CONSTEXPR inline iterator operator+(const difference_type val) const noexcept
 		{
 			iterator temp = *this;
 			temp += val;
 			return temp;
 		}
 
-		inline iterator& operator-=(const size_t val)
+		SAD_CONSTEXPR inline iterator& operator-=(const difference_type val) noexcept
 		{
 			this->m_ptr -= val;
 			return *this;
 		}
 
-		_NODISCARD inline iterator& operator-(const size_t val) const noexcept
+		_NODISCARD SAD_CONSTEXPR inline iterator operator-(const difference_type val) const noexcept
 		{
 			iterator temp = *this;
 			temp -= val;
 			return temp;
 		}
 
+		// Distance between two iterators.
+		_NODISCARD SAD_CONSTEXPR inline difference_type operator-(const const_iterator<stack_vector>& other) const noexcept
+		{
+			return this->m_ptr - other.m_ptr;
+		}
+
 		/* RELATIONAL OPERATORS */
 
-		bool operator==(const iterator& other) const
+		SAD_CONSTEXPR bool operator==(const iterator& other) const
 		{
 			return this->m_ptr == other.m_ptr;
 		}
 
-		bool operator!=(const iterator& other) const
+		SAD_CONSTEXPR bool operator!=(const iterator& other) const
 		{
 			return !(*this == other);
 		}
 
-		bool operator>=(const iterator& other) const
+		SAD_CONSTEXPR bool operator>=(const iterator& other) const
 		{
 			return this->m_ptr >= other.m_ptr;
 		}
 
-		bool operator<=(const iterator& other) const
+		SAD_CONSTEXPR bool operator<=(const iterator& other) const
 		{
 			return this->m_ptr <= other.m_ptr;
 		}
 
-		bool operator>(const iterator& other) const
+		SAD_CONSTEXPR bool operator>(const iterator& other) const
 		{
 			return this->m_ptr > other.m_ptr;
 		}
 
-		bool operator<(const iterator& other) const
+		SAD_CONSTEXPR bool operator<(const iterator& other) const
 		{
 			return this->m_ptr < other.m_ptr;
 		}
@@ -230,77 +528,239 @@ namespace sad {
 	}; // !iterator<stack_vector<T>> class
 
 
-	// Dynamic stack allocated vector
-	template<typename T>
-	class stack_vector
+	// Remembers how large the vectors created at one call site ended up, so the next one can
+	// start out at that size. Grows straight to a larger size, decays slowly towards smaller ones
+	// so a single outlier doesn't stick forever. Safe to share between threads.
+	class capacity_hint
+	{
+	public:
+		// Capacity the next vector should start with, 0 when nothing has been recorded yet.
+		_NODISCARD inline size_t get() const noexcept { return m_capacity.load(std::memory_order_relaxed); }
+
+		// Retried until no other thread recorded in between, so a larger size is never lost.
+		inline void record(size_t size) noexcept
+		{
+			size_t current = this->get();
+			size_t next;
+			do {
+				const size_t decayed = current - (current / 8);
+				next = size > decayed ? size : decayed;
+			} while (next != current && !m_capacity.compare_exchange_weak(current, next, std::memory_order_relaxed));
+		}
+
+	private:
+		std::atomic<size_t> m_capacity{ 0 };
+
+	}; // !capacity_hint class
+
+	// Hint unique to the line it is written on, e.g. stack_vector<T, 0, void, growth::hinted<>> v(SAD_CAPACITY_HINT());
+	#define SAD_CAPACITY_HINT() ([]() -> sad::capacity_hint& { static sad::capacity_hint hint; return hint; }())
+
+
+	// Growth policies, deciding how much a full vector grows by.
+	// next_capacity(current, required) returns the new capacity, at least required.
+	// initial_capacity() is what a default constructed vector without inline storage starts with.
+	// record(size) is told the size of every vector as it is destroyed.
+	namespace growth {
+
+		// Defaults shared by the policies below.
+		struct policy_base
+		{
+			SAD_CONSTEXPR inline size_t initial_capacity() const noexcept { return 2; }
+			SAD_CONSTEXPR inline void record(size_t) noexcept {}
+		};
+
+		// Grow by 1.5x.
+		struct geometric : policy_base
+		{
+			SAD_CONSTEXPR inline size_t next_capacity(size_t current, size_t required) const noexcept
+			{
+				const size_t grown = current + (current / 2);
+				return grown > required ? grown : required;
+			}
+		};
+
+		// Grow by 2x.
+		struct doubling : policy_base
+		{
+			SAD_CONSTEXPR inline size_t next_capacity(size_t current, size_t required) const noexcept
+			{
+				const size_t grown = current * 2;
+				return grown > required ? grown : required;
+			}
+		};
+
+		// Grow by Step elements at a time.
+		template<size_t Step>
+		struct fixed_step : policy_base
+		{
+			static_assert(Step > 0, "sad::growth::fixed_step needs a step of at least one element");
+
+			SAD_CONSTEXPR inline size_t next_capacity(size_t current, size_t required) const noexcept
+			{
+				const size_t grown = current + Step;
+				return grown > required ? grown : required;
+			}
+		};
+
+		// Grow to exactly what is needed, reallocating on every push_back once full.
+		struct exact : policy_base
+		{
+			SAD_CONSTEXPR inline size_t next_capacity(size_t, size_t required) const noexcept { return required; }
+		};
+
+		// Start at the size recorded in a capacity_hint and feed the final size back into it,
+		// growing like Base in between.
+		template<typename Base = geometric>
+		class hinted : public Base
+		{
+		public:
+			SAD_CONSTEXPR inline hinted() noexcept : m_hint(nullptr) {}
+			SAD_CONSTEXPR inline hinted(capacity_hint& hint) noexcept : m_hint(&hint) {}
+
+			SAD_CONSTEXPR inline size_t initial_capacity() const noexcept
+			{
+				const size_t hint = m_hint ? m_hint->get() : 0;
+				return hint > 0 ? hint : Base::initial_capacity();
+			}
+
+			SAD_CONSTEXPR inline void record(size_t size) noexcept
+			{
+				if (m_hint)
+					m_hint->record(size);
+			}
+
+		private:
+			capacity_hint* m_hint;
+		};
+
+	} // !namespace growth
+
+
+	// Stack allocated vector.
+	// N == 0 : the buffer is allocated with std::allocator. Memory alloca'd inside a member
+	//          function is gone once it returns, to put the elements on the stack use an
+	//          arena_vector over a SAD_STACK_ARENA instead (see stack_arena.hpp).
+	// N > 0  : the buffer is N elements of raw storage inside the object itself, so the
+	//          elements live wherever the vector lives. Growing past N throws std::length_error
+	//          (or aborts when exceptions are disabled), it never allocates.
+	// With a non-void Allocator the vector instead moves to a block from that allocator once it
+	// outgrows its N inline elements (see small_vector.hpp, stack_arena.hpp and memory_resource.hpp).
+	// Any allocator following the std allocator model works, elements are constructed and
+	// destroyed through std::allocator_traits.
+	// Growth decides how far the capacity grows once full, see namespace growth.
+	template<typename T, std::size_t N = 0, typename Allocator = void, typename Growth = growth::geometric>
+	class stack_vector : private detail::inline_storage<T, N>, private detail::allocator_holder<typename detail::allocator_for<T, Allocator>::type>, private detail::growth_holder<Growth>,
+		private detail::instrument_holder<stack_vector<T, N, Allocator, Growth>>
 	{
 	public:
 		using ValueType = T;
+		using allocator_type = typename detail::allocator_for<T, Allocator>::type;
+		using growth_type = Growth;
 		#if _WIN32 // Windows
-			using iterator = iterator<stack_vector<T>>;
-			using const_iterator = const_iterator<stack_vector<T>>;
+			using iterator = iterator<stack_vector>;
+			using const_iterator = const_iterator<stack_vector>;
 
 		#elif defined(__linux__) // Or #if __linux__
-			using iterator = class iterator<stack_vector<T>>;
-			using const_iterator = class const_iterator<stack_vector<T>>;
+			using iterator = class iterator<stack_vector>;
+			using const_iterator = class const_iterator<stack_vector>;
 
 		#elif defined(__APPLE__) // Or #if _APPLE_
-			using iterator = class iterator<stack_vector<T>>;
-			using const_iterator = class const_iterator<stack_vector<T>>;
+			using iterator = class iterator<stack_vector>;
+			using const_iterator = class const_iterator<stack_vector>;
 		#endif
 
+		// Number of elements stored inside the object.
+		static constexpr std::size_t inline_capacity = N;
+
 		/* Allocation / Deallocation */
 	public:
 
 		// Default constructor.
-		inline stack_vector() noexcept
+		SAD_CONSTEXPR inline stack_vector() noexcept(N > 0)
+		{
+			this->_reallocate(this->_initial_capacity());
+		}
+
+		// Construct with an allocator to spill into.
+		SAD_CONSTEXPR inline explicit stack_vector(const allocator_type& allocator) : allocator_holder(allocator)
+		{
+			this->_reallocate(this->_initial_capacity());
+		}
+
+		// Construct with a growth policy, e.g. a capacity_hint for growth::hinted.
+		SAD_CONSTEXPR inline explicit stack_vector(const growth_type& growth) : growth_holder(growth)
+		{
+			this->_reallocate(this->_initial_capacity());
+		}
+
+		// Construct with an allocator to spill into and a growth policy.
+		SAD_CONSTEXPR inline stack_vector(const allocator_type& allocator, const growth_type& growth) : allocator_holder(allocator), growth_holder(growth)
 		{
-			this->_reallocate(2);
+			this->_reallocate(this->_initial_capacity());
 		}
 
 		// Fill constructor
-		inline explicit stack_vector(size_t size)
+		SAD_CONSTEXPR inline explicit stack_vector(size_t size)
+		{
+			this->_reallocate(size);
+		}
+
+		// Fill constructor, with an allocator to spill into.
+		SAD_CONSTEXPR inline stack_vector(size_t size, const allocator_type& allocator) : allocator_holder(allocator)
 		{
 			this->_reallocate(size);
 		}
 
 		// Copy constructor
-		inline stack_vector(const stack_vector<T>& vec) noexcept
+		SAD_CONSTEXPR inline stack_vector(const stack_vector& vec)
+			: allocator_holder(allocator_traits::select_on_container_copy_construction(vec._allocator())), growth_holder(vec._growth()), instrument_holder()
 		{
 			const size_t new_size = vec.size();
 			this->_reallocate(vec.capacity());
 
 			for (size_t i = 0; i < new_size; i++)
-				m_data[i] = vec.m_data[i];
+				this->_construct(&this->_data()[i], vec._data()[i]);
 
 			this->m_size = new_size;
+			this->_instrument_size();
+			this->_instrument_copied(new_size);
 		}
 
 		// Move constructor
-		inline stack_vector(stack_vector<T>&& vec) noexcept
+		SAD_CONSTEXPR inline stack_vector(stack_vector&& vec) noexcept : allocator_holder(vec._allocator()), growth_holder(vec._growth())
 		{
+			// A separately allocated block can simply change owners.
+			if (vec._owns_allocation()) {
+				this->_steal(vec);
+				return;
+			}
+
 			const size_t new_size = vec.size();
 			this->_reallocate(vec.capacity());
 
 			for (size_t i = 0; i < new_size; i++)
-				m_data[i] = vec.m_data[i];
+				this->_construct(&this->_data()[i], std::move(vec._data()[i]));
 
 			m_size = new_size;
+			this->_instrument_size();
+			this->_instrument_moved(new_size);
 		}
 
 		// Range constructor
-		stack_vector(iterator first, iterator last)
+		template<typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+		SAD_CONSTEXPR stack_vector(InputIt first, InputIt last)
 		{
-			size_t size = last.m_ptr - first.m_ptr;
-			this->_reallocate(size);
-			this->m_size = size;
-			std::copy(first.m_ptr, last.m_ptr, this->m_data);
+			this->_reallocate(N);
+			this->insert(this->cend(), first, last);
 		}
 
 		// DESTROY!
-		~stack_vector()
+		SAD_CONSTEXPR ~stack_vector()
 		{
+			this->_growth().record(m_size);
 			this->clear();
+			this->_release();
 		}
 
 	public:
@@ -310,271 +770,225 @@ namespace sad {
 		/*----------------------------------------------------------*/
 
 		// Assign value of n amount
-		inline void assign(size_t n, const T& val)
+		SAD_CONSTEXPR inline void assign(size_t n, const T& val)
 		{
-			this->_reallocate(m_capacity + n + (m_capacity / 2));
-			m_size = n;
+			this->clear();
+			this->_reserve_for(n);
 
 			for (size_t i = 0; i < n; i++)
-				m_data[i] = T(val);
+				this->_construct(&this->_data()[i], val);
+			m_size = n;
+			this->_instrument_size();
 		}
 
 		// Assign values by initializer list.
-		inline void assign(std::initializer_list<T> init_list)
+		SAD_CONSTEXPR inline void assign(std::initializer_list<T> init_list)
 		{
 			const size_t size = init_list.size();
-			this->_reallocate(m_capacity + size + (m_capacity / 2));
-			m_size = size;
+			this->clear();
+			this->_reserve_for(size);
 
-			std::copy(init_list.begin(), init_list.end(), m_data);
+			auto it = init_list.begin();
+			for (size_t i = 0; i < size; ++i, ++it)
+				this->_construct(&this->_data()[i], *it);
+			m_size = size;
+			this->_instrument_size();
 		}
 
 		// Assign value of n amount, by iterators
-		inline void assign(const_iterator first, const_iterator last)
+		template<typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+		SAD_CONSTEXPR inline void assign(InputIt first, InputIt last)
 		{
-			const size_t size = last.m_ptr - first.m_ptr;
-			this->_reallocate(m_capacity + size + (m_capacity / 2));
-			m_size = size;
-
-			for (size_t i = 0; i < m_size; i++)
-				m_data[i] = T(*(first + i));
-
+			this->clear();
+			this->insert(this->cend(), first, last);
 		}
 
-		inline void push_back(const T& value)
+		SAD_CONSTEXPR inline void push_back(const T& value)
 		{
 			if (m_size >= m_capacity)
-				this->_reallocate(m_capacity + (m_capacity / 2));
+				return this->_grow_emplace_back(value);
 
-			m_data[m_size] = value;
+			this->_construct(&this->_data()[m_size], value);
 			m_size++;
+			this->_instrument_size();
 		}
 
-		inline void push_back(T&& value)
+		SAD_CONSTEXPR inline void push_back(T&& value)
 		{
-			std::cout << &value << "\n";
 			if (m_size >= m_capacity)
-				this->_reallocate(m_capacity + (m_capacity / 2));
+				return this->_grow_emplace_back(std::move(value));
 
-			m_data[m_size] = std::move(value);
+			this->_construct(&this->_data()[m_size], std::move(value));
 			m_size++;
+			this->_instrument_size();
 		}
 
-		inline void pop_back() noexcept
+		SAD_CONSTEXPR inline void pop_back() noexcept
 		{
 			if (m_size > 0) {
 				m_size--;
-				m_data[m_size].~T();
+				this->_destroy(&this->_data()[m_size]);
 			}
 		}
 
 		// Insert element at position.
-		inline iterator insert(const_iterator position, const T& val)
+		SAD_CONSTEXPR inline iterator insert(const_iterator position, const T& val)
 		{
-			// Calculate the index based on the pointer difference
-			auto* loc = position.m_ptr;
-			size_t index = loc - m_data;
-
-			if (m_size >= m_capacity) {
-				this->_reallocate(m_capacity + (m_capacity / 2));
-			}
-			m_size++;
-
-			// Shift elements to make space for the new one
-			for (size_t i = m_size; i > index; --i)
-				m_data[i] = std::move(m_data[i - 1]);
-
-			m_data[index] = T(val);
-
-			return iterator(m_data + index);
+			// Copy first, val may refer to an element of this vector.
+			T value(val);
+			return this->_insert_one(position.m_ptr - this->_data(), std::move(value));
 		}
 
 		// Insert element n amount of times at defined position.
-		inline iterator insert(const_iterator position, size_t n, const T& val)
+		SAD_CONSTEXPR inline iterator insert(const_iterator position, size_t n, const T& val)
 		{
 			// Calculate the index based on the pointer difference
-			auto* loc = position.m_ptr;
-			const size_t index = loc - m_data;
-
-			if (m_size >= m_capacity) {
-				this->_reallocate(m_capacity + n + (m_capacity / 2));
-			}
+			const size_t index = position.m_ptr - this->_data();
+			if (n == 0)
+				return iterator(this->_data() + index);
+
+			// Copy first, val may refer to an element of this vector.
+			const T value(val);
+			this->_reserve_for(m_size + n);
+
+			// Move the tail once, then fill the gap in place.
+			this->_open_gap(index, n);
+			gap_guard guard{ *this, index, n, 0, false };
+			for (; guard.m_built < n; guard.m_built++)
+				this->_construct(&this->_data()[index + guard.m_built], value);
+			guard.m_done = true;
 			m_size += n;
+			this->_instrument_size();
 
-			// Shift elements to make space for the new one
-			for (size_t i = m_size; i > index; --i)
-				m_data[i] = std::move(m_data[i - n]);
-
-			// Add the values n amount of times.
-			for (size_t i = index; i < index + n; ++i)
-				m_data[i] = std::move(val);
-
-			return iterator(m_data + index);
+			return iterator(this->_data() + index);
 		}
 
 		// Insert element n amount of times at defined position.
-		inline iterator insert(const_iterator position, size_t n, const T&& val)
+		SAD_CONSTEXPR inline iterator insert(const_iterator position, size_t n, const T&& val)
 		{
-			// Calculate the index based on the pointer difference
-			auto* loc = position.m_ptr;
-			const size_t index = loc - m_data;
-
-			if (m_size >= m_capacity) {
-				this->_reallocate(m_capacity + n + (m_capacity / 2));
-			}
-			m_size += n;
-
-			// Shift elements to make space for the new one
-			for (size_t i = m_size; i > index; --i)
-				m_data[i] = std::move(m_data[i - n]);
-
-			// Add the values n amount of times.
-			for (size_t i = index; i < index + n; ++i)
-				m_data[i] = std::move(val);
-
-			return iterator(m_data + index);
+			return this->insert(position, n, static_cast<const T&>(val));
 		}
 
-		// Insert element n amount of times at position, with iterators.
-		inline iterator insert(const_iterator position, const_iterator first, const_iterator last)
+		// Insert a range at position, from any input iterators.
+		template<typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+		SAD_CONSTEXPR inline iterator insert(const_iterator position, InputIt first, InputIt last)
 		{
-			auto* loc = position.m_ptr;
-			const size_t index = loc - m_data;
-			const size_t n = last.m_ptr - first.m_ptr;
-
-			if (m_size >= m_capacity) {
-				this->_reallocate(m_capacity + n + (m_capacity / 2));
-			}
-			m_size += n;
-
-			// Shift elements by n-spaces, to make space for the new one
-			for (size_t i = m_size; i > n; --i)
-				m_data[i] = std::move(m_data[i - n]);
-
-			// Add the values n-amount of times.
-			for (size_t i = index + 1; i < index + n; ++i)
-				m_data[i] = T(first.m_ptr[i]);
-
-			return iterator(m_data + index);
+			return this->_insert_range(position.m_ptr - this->_data(), first, last, typename std::iterator_traits<InputIt>::iterator_category());
 		}
 
-		inline iterator insert(const_iterator position, std::initializer_list<T> init_list)
+		SAD_CONSTEXPR inline iterator insert(const_iterator position, std::initializer_list<T> init_list)
 		{
-			auto* loc = position.m_ptr;
-			const size_t index = loc - m_data;
-			const size_t n = init_list.size();
-
-			if (m_size >= m_capacity) {
-				this->_reallocate(m_capacity + n + (m_capacity / 2));
-			}
-			m_size += n;
-
-			// Shift elements by n-spaces, to make space for the new one
-			for (size_t i = m_size; i > n; --i)
-				m_data[i] = std::move(m_data[i - n]);
+			return this->_insert_range(position.m_ptr - this->_data(), init_list.begin(), init_list.end(), std::random_access_iterator_tag());
+		}
 
-			// Add the values n-amount of times.
-			auto it = init_list.begin();
-			for (size_t i = 0; i < n; ++i, ++it)
-				new (&m_data[index + i]) T(*it);
+		// Insert every element of a range (anything with begin() and end()) at the end.
+		template<typename Range>
+		SAD_CONSTEXPR inline void append_range(Range&& range)
+		{
+			this->insert(this->cend(), detail::range_begin(range), detail::range_end(range));
+		}
 
-			return iterator(m_data + index);
+		// Replace the contents with the elements of a range.
+		template<typename Range>
+		SAD_CONSTEXPR inline void assign_range(Range&& range)
+		{
+			this->clear();
+			this->append_range(std::forward<Range>(range));
 		}
 
-		inline iterator erase(const_iterator position) noexcept
+		SAD_CONSTEXPR inline iterator erase(const_iterator position) noexcept
 		{
 			// Calculate the index based on the pointer difference
 			auto* loc = position.m_ptr;
-			size_t index = loc - m_data;
+			size_t index = loc - this->_data();
 
-			// Delete element at location
-			m_data[index].~T();
-			m_size--;
-
-			// Shift elements to compensate for removed element
-			for (size_t i = index; i < m_size; i++)
-				m_data[i] = std::move(m_data[i + 1]);
+			this->_erase_range(index, 1);
 
-			return iterator(m_data + index);
+			return iterator(this->_data() + index);
 		}
 
-		inline iterator erase(const_iterator first, const_iterator last) noexcept
+		SAD_CONSTEXPR inline iterator erase(const_iterator first, const_iterator last) noexcept
 		{
 			// Ensure the range is valid
-			assert(first.m_ptr >= m_data && first.m_ptr <= m_data + m_size);
-			assert(last.m_ptr >= m_data && last.m_ptr <= m_data + m_size);
+			assert(first.m_ptr >= this->_data() && first.m_ptr <= this->_data() + m_size);
+			assert(last.m_ptr >= this->_data() && last.m_ptr <= this->_data() + m_size);
 			assert(first.m_ptr <= last.m_ptr);
 
-			const size_t start_index = first.m_ptr - m_data;
-			const size_t end_index = last.m_ptr - m_data;
+			const size_t start_index = first.m_ptr - this->_data();
 			const size_t n = last.m_ptr - first.m_ptr;
 
-			// Destroy elements at these indices
-			for (size_t i = start_index; i < end_index; ++i)
-				m_data[i].~T();
+			this->_erase_range(start_index, n);
 
-			// Shift elements after the erased range to fill the gap
-			for (size_t i = end_index; i < m_size; ++i)
-				m_data[i - n] = std::move(m_data[i]);
+			return iterator(this->_data() + start_index);
+		}
+
+		// Erase by moving the last element into position instead of shifting the tail down.
+		// O(1), but the element order is not kept. Returns an iterator to the same position.
+		SAD_CONSTEXPR inline iterator unordered_erase(const_iterator position)
+		{
+			const size_t index = position.m_ptr - this->_data();
+			assert(index < m_size);
 
-			m_size -= n;
+			const size_t last = m_size - 1;
+			if (index != last)
+				this->_data()[index] = std::move(this->_data()[last]);
+			this->_destroy(&this->_data()[last]);
+			m_size--;
 
-			return iterator(m_data + start_index);
+			return iterator(this->_data() + index);
 		}
 
-		inline void swap(stack_vector<T>& other) noexcept
+		// Erase every element pred returns true for in a single pass, keeping the order of the rest.
+		// pred is called once per element, front to back. Returns how many were erased.
+		template<typename Pred>
+		inline size_t erase_if(Pred pred)
 		{
-			std::swap(m_size, other.m_size);
-			std::swap(m_capacity, other.m_capacity);
-			std::swap(m_data, other.m_data);
+			const size_t old_size = m_size;
+			this->_erase_if(pred, relocatable());
+			return old_size - m_size;
 		}
 
-		inline void swap(stack_vector<T>&& other) noexcept
+		// Erase every element whose bit is set in mask, bit i % 64 of mask[i / 64] standing for
+		// element i, keeping the order of the rest. Returns how many were erased.
+		inline size_t erase_marked(const std::uint64_t* mask) noexcept
 		{
-			std::swap(m_size, other.m_size);
-			std::swap(m_capacity, other.m_capacity);
-			std::swap(m_data, other.m_data);
+			return this->erase_marked(mask, (m_size + 63) / 64);
 		}
 
-		template<typename... Args>
-		inline iterator emplace(const_iterator position, Args&&... args)
+		// Same, for a mask of only words words, the elements past it are all kept.
+		inline size_t erase_marked(const std::uint64_t* mask, const size_t words) noexcept
 		{
-			// Calculate the index based on the pointer difference
-			auto* loc = position.m_ptr;
-			size_t index = loc - m_data;
-
-			if (m_size >= m_capacity) {
-				this->_reallocate(m_capacity + (m_capacity / 2));
-			}
-			m_size++;
+			const size_t old_size = m_size;
+			this->_compact([mask, words](size_t word) { return word < words ? mask[word] : std::uint64_t(0); }, relocatable());
+			return old_size - m_size;
+		}
 
-			// Shift elements to make space for the new one
-			for (size_t i = m_size; i > index; --i)
-				m_data[i] = std::move(m_data[i - 1]);
+		SAD_CONSTEXPR inline void swap(stack_vector& other) noexcept
+		{
+			this->_swap(other, storage_category());
+		}
 
-			m_data[index] = T(std::forward<Args>(args)...);
+		SAD_CONSTEXPR inline void swap(stack_vector&& other) noexcept
+		{
+			this->_swap(other, storage_category());
+		}
 
-			return iterator(m_data + index);
+		template<typename... Args>
+		SAD_CONSTEXPR inline iterator emplace(const_iterator position, Args&&... args)
+		{
+			T value(std::forward<Args>(args)...);
+			return this->_insert_one(position.m_ptr - this->_data(), std::move(value));
 		}
 
 		template<typename... Args>
-		void emplace_back(Args&&... args)
+		SAD_CONSTEXPR void emplace_back(Args&&... args)
 		{
 			if (m_size >= m_capacity)
-				this->_reallocate(m_capacity + (m_capacity / 2));
+				return this->_grow_emplace_back(std::forward<Args>(args)...);
 
-			new(&m_data[m_size]) T(std::forward<Args>(args)...);
+			this->_construct(&this->_data()[m_size], std::forward<Args>(args)...);
 			m_size++;
-		}
-
-		// Flip each boolean in list.
-		template <typename U = T, typename std::enable_if<std::is_same<U, bool>::value, int>::type = 0>
-		inline void flip() noexcept
-		{
-			for (size_t i = 0; i < m_size; ++i)
-			{
-				m_data[i] = !m_data[i];
-			}
+			this->_instrument_size();
 		}
 
 		/*----------------------------------------------------------*/
@@ -583,57 +997,57 @@ namespace sad {
 		// Get the first element.
 
 		// Get copy of element at this index.
-		_NODISCARD inline T at(const size_t index)
+		_NODISCARD SAD_CONSTEXPR inline T at(const size_t index)
 		{
-			assert((index >= 0 && index < m_capacity));
-			return m_data[index];
+			assert(index < m_capacity);
+			return this->_data()[index];
 		}
 
 		// Get copy of element at this index as const.
-		_NODISCARD inline const T at(const size_t index) const
+		_NODISCARD SAD_CONSTEXPR inline const T at(const size_t index) const
 		{
-			assert((index >= 0 && index < m_capacity));
-			return m_data[index];
+			assert(index < m_capacity);
+			return this->_data()[index];
 		}
 
 		// Get the first element.
-		_NODISCARD inline T& front()
+		_NODISCARD SAD_CONSTEXPR inline T& front()
 		{
 			assert(m_size > 0);
-			return m_data[0];
+			return this->_data()[0];
 		}
 
 		// Get the first element as const.
-		_NODISCARD inline const T& front() const
+		_NODISCARD SAD_CONSTEXPR inline const T& front() const
 		{
 			assert(m_size > 0);
-			return m_data[0];
+			return this->_data()[0];
 		}
 
 		// Get the last element.
-		_NODISCARD inline T& back()
+		_NODISCARD SAD_CONSTEXPR inline T& back()
 		{
 			assert(m_size > 0);
-			return m_data[m_size - 1];
+			return this->_data()[m_size - 1];
 		}
 
 		// Get the last element as const.
-		_NODISCARD inline const T& back() const
+		_NODISCARD SAD_CONSTEXPR inline const T& back() const
 		{
 			assert(m_size > 0);
-			return m_data[m_size - 1];
+			return this->_data()[m_size - 1];
 		}
 
 		// Get array
-		T* data() noexcept
+		SAD_CONSTEXPR T* data() noexcept
 		{
-			return this->m_data;
+			return this->_data();
 		}
 
 		// Get array copy
-		const T* data() const noexcept
+		SAD_CONSTEXPR const T* data() const noexcept
 		{
-			return this->m_data;
+			return this->_data();
 		}
 
 		/*----------------------------------------------------------*/
@@ -645,24 +1059,24 @@ namespace sad {
 		/* -------------------------------*/
 
 		// iterator pointing at the start.
-		_NODISCARD inline iterator begin() noexcept
+		_NODISCARD SAD_CONSTEXPR inline iterator begin() noexcept
 		{
-			return iterator(m_data);
+			return iterator(this->_data());
 		}
 		// iterator pointing at the end.
-		_NODISCARD inline iterator end() noexcept
+		_NODISCARD SAD_CONSTEXPR inline iterator end() noexcept
 		{
-			return iterator(m_data + (m_size));
+			return iterator(this->_data() + (m_size));
 		}
 		// iterator pointing at the reversed start.
-		_NODISCARD inline iterator rbegin() noexcept
+		_NODISCARD SAD_CONSTEXPR inline iterator rbegin() noexcept
 		{
-			return iterator(m_data + (m_size));
+			return iterator(this->_data() + (m_size));
 		}
 		// iterator pointing at the reversed end.
-		_NODISCARD inline iterator rend() noexcept
+		_NODISCARD SAD_CONSTEXPR inline iterator rend() noexcept
 		{
-			return iterator(m_data);
+			return iterator(this->_data());
 		}
 
 		/* -------------------------------*/
@@ -670,27 +1084,27 @@ namespace sad {
 		/* -------------------------------*/
 
 		// const_iterator pointing at the start.
-		_NODISCARD inline const_iterator begin() const noexcept
+		_NODISCARD SAD_CONSTEXPR inline const_iterator begin() const noexcept
 		{
-			return const_iterator(m_data);
+			return const_iterator(this->_data());
 		}
 
 		// const_iterator pointing at the end.
-		_NODISCARD inline const_iterator end() const noexcept
+		_NODISCARD SAD_CONSTEXPR inline const_iterator end() const noexcept
 		{
-			return const_iterator(m_data + (m_size));
+			return const_iterator(this->_data() + (m_size));
 		}
 
 		// const_iterator pointing at the reversed start.
-		_NODISCARD inline const_iterator rbegin() const noexcept
+		_NODISCARD SAD_CONSTEXPR inline const_iterator rbegin() const noexcept
 		{
-			return const_iterator(m_data + (m_size));
+			return const_iterator(this->_data() + (m_size));
 		}
 
 		// const_iterator pointing at the reversed end.
-		_NODISCARD inline const_iterator rend() const noexcept
+		_NODISCARD SAD_CONSTEXPR inline const_iterator rend() const noexcept
 		{
-			return const_iterator(m_data);
+			return const_iterator(this->_data());
 		}
 
 		/* -------------------------------*/
@@ -698,24 +1112,24 @@ namespace sad {
 		/* -------------------------------*/
 
 		//constant const_iterator pointing at the start.
-		_NODISCARD inline const_iterator cbegin() const noexcept
+		_NODISCARD SAD_CONSTEXPR inline const_iterator cbegin() const noexcept
 		{
-			return const_iterator(m_data);
+			return const_iterator(this->_data());
 		}
 		//constant const_iterator pointing at the end.
-		_NODISCARD inline const_iterator cend() const noexcept
+		_NODISCARD SAD_CONSTEXPR inline const_iterator cend() const noexcept
 		{
-			return const_iterator(m_data + (m_size));
+			return const_iterator(this->_data() + (m_size));
 		}
 		//constant const_iterator pointing at the reversed start.
-		_NODISCARD inline const_iterator crbegin() const noexcept
+		_NODISCARD SAD_CONSTEXPR inline const_iterator crbegin() const noexcept
 		{
-			return const_iterator(m_data + (m_size));
+			return const_iterator(this->_data() + (m_size));
 		}
 		//constant const_iterator pointing at the reversed end.
-		_NODISCARD inline const_iterator crend() const noexcept
+		_NODISCARD SAD_CONSTEXPR inline const_iterator crend() const noexcept
 		{
-			return const_iterator(m_data);
+			return const_iterator(this->_data());
 		}
 
 		/*----------------------------------------------------------*/
@@ -723,45 +1137,104 @@ namespace sad {
 		/*----------------------------------------------------------*/
 
 		// Get amount of elements.
-		_NODISCARD inline size_t size() const noexcept { return this->m_size; }
+		_NODISCARD SAD_CONSTEXPR inline size_t size() const noexcept { return this->m_size; }
 
-		_NODISCARD inline size_t max_size() const noexcept { return std::numeric_limits<size_t>::max() / sizeof(T); }
+		_NODISCARD SAD_CONSTEXPR inline size_t max_size() const noexcept { return (std::is_void<Allocator>::value && N > 0) ? N : std::numeric_limits<size_t>::max() / sizeof(T); }
 
 		// Get amount of elements that can fit.
-		size_t capacity() const noexcept { return this->m_capacity; }
+		SAD_CONSTEXPR size_t capacity() const noexcept { return this->m_capacity; }
+
+		// Get a copy of the allocator used once the inline buffer is outgrown.
+		_NODISCARD inline allocator_type get_allocator() const noexcept { return this->_allocator(); }
+
+		// Attach call site counters, see SAD_INSTRUMENT in instrumentation.hpp.
+		using detail::instrument_holder<stack_vector>::instrument;
+
+		// Check if the elements are in the inline buffer.
+		_NODISCARD SAD_CONSTEXPR inline bool is_inline() const noexcept { return N > 0 && this->_data() == this->_inline_data(); }
+
+		// Check if the elements have moved out of the inline buffer, always true when N is 0.
+		_NODISCARD SAD_CONSTEXPR inline bool spilled() const noexcept { return !this->is_inline(); }
 
 		// Destroy vector contents
-		inline void clear() noexcept
+		SAD_CONSTEXPR inline void clear() noexcept
 		{
 			for (size_t i = 0; i < m_size; i++)
-				this->m_data[i].~T();
+				this->_destroy(&this->_data()[i]);
 			this->m_size = 0;
 		}
 
-		// Change size
-		inline void resize(size_t size, T value = T())
+		// Change size, value-initialising new elements in place.
+		SAD_CONSTEXPR inline void resize(size_t size)
 		{
-			this->_reallocate(size);
+			this->_shrink_to(size < m_size ? size : m_size);
+			this->_reserve_for(size);
+
 			for (size_t i = m_size; i < size; i++)
-				this->m_data[i] = value;
+				this->_construct(&this->_data()[i]);
 
 			this->m_size = size;
+			this->_instrument_size();
 		}
 
-		// Reserve some n-th space, resize array if needed.
-		inline void reserve(size_t new_capacity)
+		// Change size, copying value into new elements.
+		SAD_CONSTEXPR inline void resize(size_t size, const T& value)
+		{
+			this->_shrink_to(size < m_size ? size : m_size);
+			this->_reserve_for(size);
+
+			for (size_t i = m_size; i < size; i++)
+				this->_construct(&this->_data()[i], value);
+
+			this->m_size = size;
+			this->_instrument_size();
+		}
+
+		// Change size, default-initialising new elements: trivial types are left unwritten, for
+		// when the caller overwrites them anyway. Bypasses the allocator's construct().
+		inline void resize_for_overwrite(size_t size)
+		{
+			this->_shrink_to(size < m_size ? size : m_size);
+			this->_reserve_for(size);
+
+			for (size_t i = m_size; i < size; i++)
+				::new (static_cast<void*>(&this->_data()[i])) T;
+
+			this->m_size = size;
+			this->_instrument_size();
+		}
+
+		// Make room for n more elements and return the raw space after the last one, for a
+		// kernel, read() or SIMD stores to fill directly. commit() then adds what was written.
+		// The span stays valid until the vector next reallocates.
+		_NODISCARD inline span<T> reserve_and_append_uninitialized(size_t n)
+		{
+			static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+				"sad::stack_vector: uninitialised appends need a trivially copyable and destructible T");
+
+			this->_reserve_for(m_size + n);
+			return span<T>(this->_data() + m_size, n);
+		}
+
+		// Add the first n elements written after the last one, see reserve_and_append_uninitialized.
+		inline void commit(size_t n) noexcept
 		{
-			bool resize = false;
-			(new_capacity > m_capacity) ? (m_capacity = new_capacity) : (resize = true);
+			assert(n <= m_capacity - m_size);
+			m_size += n;
+			this->_instrument_size();
+		}
 
-			if (resize)
-				this->_reallocate(m_capacity);
+		// Reserve some n-th space, resize array if needed.
+		SAD_CONSTEXPR inline void reserve(size_t new_capacity)
+		{
+			if (new_capacity > m_capacity)
+				this->_reallocate(new_capacity);
 		}
 
 		// Check if empty
-		_NODISCARD inline bool empty() const { return (this->m_size == 0); }
+		_NODISCARD SAD_CONSTEXPR inline bool empty() const { return (this->m_size == 0); }
 
-		void shrink_to_fit() { m_capacity = m_size; }
+		SAD_CONSTEXPR void shrink_to_fit() { this->_reallocate(m_size); }
 
 		/*----------------------------------------------------------*/
 		/*						Operator Overload					*/
@@ -770,169 +1243,636 @@ namespace sad {
 		void* operator new(size_t size); // Disable new
 		void operator delete(void*); // Disable delete
 
-		T& operator[](const size_t index) noexcept
+		SAD_CONSTEXPR T& operator[](const size_t index) noexcept
 		{
-			assert((index >= 0 && index < m_capacity));
-			return this->m_data[index];
+			assert(index < m_capacity);
+			return this->_data()[index];
 		}
 
-		const T& operator[](const size_t index) const noexcept
+		SAD_CONSTEXPR const T& operator[](const size_t index) const noexcept
 		{
-			assert((index >= 0 && index < m_capacity));
-			return this->m_data[index];
+			assert(index < m_capacity);
+			return this->_data()[index];
 		}
 
 		/* Assignment */
-		inline stack_vector<T>& operator=(const stack_vector<T>& rhs) noexcept
+		SAD_CONSTEXPR inline stack_vector& operator=(const stack_vector& rhs)
 		{
+			if (this == &rhs)
+				return *this;
+
 			// Resize array
-			this->_reallocate(rhs.m_size);
-			this->m_size = rhs.m_size;
+			this->clear();
+			if (rhs.m_size > m_capacity)
+				this->_reallocate(rhs.m_size);
 
-			// Move values over
-			for (size_t i = 0; i < this->m_size; i++)
+			// Copy values over
+			for (size_t i = 0; i < rhs.m_size; i++)
 			{
-				this->m_data[i] = rhs.m_data[i];
+				this->_construct(&this->_data()[i], rhs._data()[i]);
 			}
+			this->m_size = rhs.m_size;
+			this->_instrument_size();
+			this->_instrument_copied(rhs.m_size);
 
 			return *this;
 		}
 
-		inline stack_vector<T>& operator= (stack_vector<T>&& rhs)
+		SAD_CONSTEXPR inline stack_vector& operator= (stack_vector&& rhs)
 		{
+			if (this == &rhs)
+				return *this;
+
+			// Take over a separately allocated block instead of moving each element.
+			if (rhs._owns_allocation() && (allocator_traits::propagate_on_container_move_assignment::value || this->_allocator() == rhs._allocator())) {
+				this->clear();
+				this->_release();
+				this->_allocator() = rhs._allocator();
+				this->_steal(rhs);
+				return *this;
+			}
+
 			// Resize array
-			this->_reallocate(rhs.m_size);
-			this->m_size = rhs.m_size;
+			this->clear();
+			if (rhs.m_size > m_capacity)
+				this->_reallocate(rhs.m_size);
 
 			// Move values over
-			for (size_t i = 0; i < this->m_size; i++)
+			for (size_t i = 0; i < rhs.m_size; i++)
 			{
-				this->m_data[i] = std::move(rhs.m_data[i]);
+				this->_construct(&this->_data()[i], std::move(rhs._data()[i]));
 			}
+			this->m_size = rhs.m_size;
+			this->_instrument_size();
+			this->_instrument_moved(rhs.m_size);
 
 			return *this;
 		}
 
 		/* Relational */
-		inline bool operator== (const stack_vector<T> rhs)
+		// Lexicographic three-way comparison, negative when this comes first, 0 when equal, positive after.
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD SAD_CONSTEXPR inline int compare(const stack_vector<T, M, A, G>& rhs) const
 		{
-			bool same_size = (this->m_size == rhs.m_size); // Check if both vectors are of the same size.
-			bool elem_check = false;
+			return detail::compare(this->data(), m_size, rhs.data(), rhs.size(), comparable());
+		}
 
-			for (size_t i = 0; i < this->m_size; i++)
-			{
-				elem_check = (this->m_data[i] == rhs.m_data[i]);
-			}
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD SAD_CONSTEXPR inline bool operator==(const stack_vector<T, M, A, G>& rhs) const
+		{
+			return m_size == rhs.size() && detail::equal(this->data(), rhs.data(), m_size, comparable());
+		}
 
-			return (same_size && elem_check);
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD SAD_CONSTEXPR inline bool operator!=(const stack_vector<T, M, A, G>& rhs) const
+		{
+			return !(*this == rhs);
 		}
 
-		inline bool operator!=(const stack_vector<T> rhs)
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD SAD_CONSTEXPR inline bool operator<(const stack_vector<T, M, A, G>& rhs) const
 		{
-			bool same_size = (this->m_size != rhs.m_size); // Check if both vectors are not of the same size.
-			bool elem_check = false;
+			return this->compare(rhs) < 0;
+		}
 
-			for (size_t i = 0; i < this->m_size; i++)
-			{
-				elem_check = (this->m_data[i] != rhs.m_data[i]);
-			}
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD SAD_CONSTEXPR inline bool operator<=(const stack_vector<T, M, A, G>& rhs) const
+		{
+			return this->compare(rhs) <= 0;
+		}
 
-			return (same_size || elem_check);
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD SAD_CONSTEXPR inline bool operator>(const stack_vector<T, M, A, G>& rhs) const
+		{
+			return this->compare(rhs) > 0;
 		}
 
-		inline bool operator<(const stack_vector<T> rhs)
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD SAD_CONSTEXPR inline bool operator>=(const stack_vector<T, M, A, G>& rhs) const
 		{
-			bool same_size = (this->m_size < rhs.m_size); // Check if right vector is larger.
-			bool elem_check = false;
+			return this->compare(rhs) >= 0;
+		}
 
-			for (size_t i = 0; i < this->m_size; i++)
-			{
-				elem_check = (this->m_data[i] < rhs.m_data[i]);
+		/* Helper Functions */
+	private:
+		using storage_category = typename detail::storage_category<N, Allocator>::type;
+		using relocatable = std::integral_constant<bool, is_trivially_relocatable<T>::value>;
+		using comparable = std::integral_constant<bool, is_trivially_comparable<T>::value>;
+		using allocator_holder = detail::allocator_holder<allocator_type>;
+		using growth_holder = detail::growth_holder<Growth>;
+		using instrument_holder = detail::instrument_holder<stack_vector>;
+		using allocator_traits = std::allocator_traits<allocator_type>;
+
+		// Capacity to grow to when the vector is full, always at least one more slot.
+		SAD_CONSTEXPR inline size_t _next_capacity() const noexcept
+		{
+			return this->_growth().next_capacity(m_capacity, m_capacity + 1);
+		}
+
+		// Capacity a new vector starts with, the inline buffer unless the growth policy wants more
+		// and there is somewhere to put it.
+		SAD_CONSTEXPR inline size_t _initial_capacity() const noexcept
+		{
+			const size_t initial = this->_growth().initial_capacity();
+			if (N > 0 && (std::is_void<Allocator>::value || initial <= N))
+				return N;
+
+			return initial;
+		}
+
+		// emplace_back once the vector is full. The element is built before growing, args may
+		// refer to an element of this vector and the old buffer is gone after _reallocate.
+		template<typename... Args>
+		SAD_CONSTEXPR inline void _grow_emplace_back(Args&&... args)
+		{
+			T value(std::forward<Args>(args)...);
+			this->_reallocate(this->_next_capacity());
+
+			this->_construct(&this->_data()[m_size], std::move(value));
+			m_size++;
+			this->_instrument_size();
+		}
+
+		// Place value at index, shifting the tail one slot to the right.
+		SAD_CONSTEXPR inline iterator _insert_one(const size_t index, T&& value)
+		{
+			if (m_size >= m_capacity)
+				this->_reallocate(this->_next_capacity());
+
+			this->_open_gap(index, 1);
+			gap_guard guard{ *this, index, 1, 0, false };
+			this->_construct(&this->_data()[index], std::move(value));
+			guard.m_done = true;
+			m_size++;
+			this->_instrument_size();
+
+			return iterator(this->_data() + index);
+		}
+
+		// Make room for required elements with at most one reallocation.
+		SAD_CONSTEXPR inline void _reserve_for(const size_t required)
+		{
+			if (required > m_capacity)
+				this->_reallocate(this->_growth().next_capacity(m_capacity, required));
+		}
+
+		// Count the range first so the tail is moved once and the new elements built in place.
+		template<typename ForwardIt>
+		SAD_CONSTEXPR inline iterator _insert_range(const size_t index, ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+		{
+			const size_t n = static_cast<size_t>(std::distance(first, last));
+			if (n == 0)
+				return iterator(this->_data() + index);
+
+			this->_reserve_for(m_size + n);
+
+			this->_open_gap(index, n);
+			gap_guard guard{ *this, index, n, 0, false };
+			for (; guard.m_built < n; guard.m_built++, ++first)
+				this->_construct(&this->_data()[index + guard.m_built], *first);
+			guard.m_done = true;
+			m_size += n;
+			this->_instrument_size();
+
+			return iterator(this->_data() + index);
+		}
+
+		// Single pass ranges can't be counted up front, so append them and rotate into place.
+		template<typename InputIt>
+		SAD_CONSTEXPR inline iterator _insert_range(const size_t index, InputIt first, InputIt last, std::input_iterator_tag)
+		{
+			const size_t old_size = m_size;
+			for (; first != last; ++first)
+				this->emplace_back(*first);
+
+			std::rotate(this->_data() + index, this->_data() + old_size, this->_data() + m_size);
+
+			return iterator(this->_data() + index);
+		}
+
+		// Move [index, m_size) up by count, leaving [index, index + count) as raw memory.
+		// m_size is left alone, the caller constructs the gap and accounts for it.
+		SAD_CONSTEXPR inline void _open_gap(const size_t index, const size_t count)
+		{
+			if (index < m_size)
+				this->_instrument_moved(m_size - index);
+			this->_open_gap(index, count, relocatable());
+		}
+
+		SAD_CONSTEXPR inline void _open_gap(const size_t index, const size_t count, std::true_type) noexcept
+		{
+			if (SAD_IS_CONSTANT_EVALUATED())
+				return this->_open_gap(index, count, std::false_type());
+			if (index < m_size)
+				std::memmove(static_cast<void*>(this->_data() + index + count), static_cast<const void*>(this->_data() + index), (m_size - index) * sizeof(T));
+		}
+
+		SAD_CONSTEXPR inline void _open_gap(const size_t index, const size_t count, std::false_type)
+		{
+			for (size_t i = m_size; i > index; --i) {
+				// Past the old end the slots are raw, below it they hold live objects.
+				if (i - 1 + count >= m_size)
+					this->_construct(&this->_data()[i - 1 + count], std::move(this->_data()[i - 1]));
+				else
+					this->_data()[i - 1 + count] = std::move(this->_data()[i - 1]);
 			}
 
-			return (same_size || elem_check);
+			// Destroy the moved-from objects left inside the gap.
+			const size_t gap_end = (index + count < m_size) ? index + count : m_size;
+			for (size_t i = index; i < gap_end; ++i)
+				this->_destroy(&this->_data()[i]);
 		}
 
-		inline bool operator<=(const stack_vector<T> rhs)
+		// Closes the gap again if constructing the elements meant for it throws, so a failed insert
+		// leaves the vector as it was.
+		struct gap_guard
 		{
-			bool same_size = (this->m_size <= rhs.m_size); // Check if right vector is larger or equal.
-			bool elem_check = false;
+			stack_vector& m_vector;
+			size_t m_index;
+			size_t m_count;
+			size_t m_built; // Elements constructed in the gap so far.
+			bool m_done;
+			SAD_CONSTEXPR inline ~gap_guard() { if (!m_done) m_vector._close_gap(m_index, m_count, m_built); }
+		};
 
-			for (size_t i = 0; i < this->m_size; i++)
-			{
-				elem_check = (this->m_data[i] <= rhs.m_data[i]);
+		// Undo _open_gap(index, count): destroy the first built elements of the gap and move the tail
+		// back down over it. m_size still counts the elements from before the gap was opened.
+		SAD_CONSTEXPR inline void _close_gap(const size_t index, const size_t count, const size_t built) noexcept
+		{
+			for (size_t i = index; i < index + built; ++i)
+				this->_destroy(&this->_data()[i]);
+			this->_close_gap(index, count, relocatable());
+		}
+
+		SAD_CONSTEXPR inline void _close_gap(const size_t index, const size_t count, std::true_type) noexcept
+		{
+			if (SAD_IS_CONSTANT_EVALUATED())
+				return this->_close_gap(index, count, std::false_type());
+			if (index < m_size)
+				std::memmove(static_cast<void*>(this->_data() + index), static_cast<const void*>(this->_data() + index + count), (m_size - index) * sizeof(T));
+		}
+
+		SAD_CONSTEXPR inline void _close_gap(const size_t index, const size_t count, std::false_type) noexcept
+		{
+			for (size_t i = index; i < m_size; ++i) {
+				// Inside the gap the slots are raw, past it they hold live objects.
+				if (i < index + count)
+					this->_construct(&this->_data()[i], std::move(this->_data()[i + count]));
+				else
+					this->_data()[i] = std::move(this->_data()[i + count]);
 			}
 
-			return (same_size && elem_check);
+			// Destroy the moved-from objects past the old end, the gap slots there were never constructed.
+			const size_t live_begin = (index + count > m_size) ? index + count : m_size;
+			for (size_t i = live_begin; i < m_size + count; ++i)
+				this->_destroy(&this->_data()[i]);
 		}
 
-		inline bool operator>(const stack_vector<T> rhs)
+		// Destroy [index, index + count) and move the tail down over it.
+		SAD_CONSTEXPR inline void _erase_range(const size_t index, const size_t count) noexcept
 		{
-			bool same_size = (this->m_size > rhs.m_size); // Check if right vector is smaller.
-			bool elem_check = false;
+			if (count == 0)
+				return;
 
-			for (size_t i = 0; i < this->m_size; i++)
-			{
-				elem_check = (this->m_data[i] > rhs.m_data[i]);
+			this->_instrument_moved(m_size - index - count);
+			this->_erase_range(index, count, relocatable());
+			m_size -= count;
+		}
+
+		SAD_CONSTEXPR inline void _erase_range(const size_t index, const size_t count, std::true_type) noexcept
+		{
+			if (SAD_IS_CONSTANT_EVALUATED())
+				return this->_erase_range(index, count, std::false_type());
+
+			for (size_t i = index; i < index + count; ++i)
+				this->_destroy(&this->_data()[i]);
+
+			std::memmove(static_cast<void*>(this->_data() + index), static_cast<const void*>(this->_data() + index + count), (m_size - index - count) * sizeof(T));
+		}
+
+		SAD_CONSTEXPR inline void _erase_range(const size_t index, const size_t count, std::false_type) noexcept
+		{
+			// Shift elements after the erased range to fill the gap
+			for (size_t i = index + count; i < m_size; ++i)
+				this->_data()[i - count] = std::move(this->_data()[i]);
+
+			// Destroy the vacated tail
+			for (size_t i = m_size - count; i < m_size; ++i)
+				this->_destroy(&this->_data()[i]);
+		}
+
+		// Without trivial relocation, move every kept element down over the erased ones.
+		template<typename Pred>
+		inline void _erase_if(Pred& pred, std::false_type)
+		{
+			size_t kept = 0;
+			for (size_t i = 0; i < m_size; i++) {
+				if (pred(this->_data()[i]))
+					continue;
+				if (kept != i)
+					this->_data()[kept] = std::move(this->_data()[i]);
+				kept++;
 			}
+			this->_shrink_to(kept);
+		}
 
-			return (same_size || elem_check);
+		// With trivial relocation, run pred over a word's worth of elements at a time without
+		// branching, then compact by whole runs of kept elements.
+		template<typename Pred>
+		inline void _erase_if(Pred& pred, std::true_type)
+		{
+			T* data = this->_data();
+			const size_t size = m_size;
+			this->_compact([data, size, &pred](size_t word) {
+				const size_t base = word * 64;
+				const size_t count = size - base < 64 ? size - base : 64;
+
+				std::uint64_t erase = 0;
+				for (size_t i = 0; i < count; i++)
+					erase |= static_cast<std::uint64_t>(pred(data[base + i]) ? 1 : 0) << i;
+				return erase;
+			}, std::true_type());
 		}
 
-		inline bool operator>=(const stack_vector<T> rhs)
+		template<typename Mask>
+		inline void _compact(Mask mask, std::false_type)
 		{
-			bool same_size = (this->m_size >= rhs.m_size); // Check if right vector is smaller or equal.
-			bool elem_check = false;
+			size_t kept = 0;
+			for (size_t i = 0; i < m_size; i++) {
+				if ((mask(i / 64) >> (i % 64)) & 1u)
+					continue;
+				if (kept != i)
+					this->_data()[kept] = std::move(this->_data()[i]);
+				kept++;
+			}
+			this->_shrink_to(kept);
+		}
 
-			for (size_t i = 0; i < this->m_size; i++)
+		// Stream compaction, 64 elements at a time: erased elements are destroyed, then a word with
+		// nothing erased is moved down with one memmove and any other word is compacted branch free.
+		// mask(word) gives the elements of that word to erase, and may throw, in which case the
+		// elements not yet looked at are kept.
+		template<typename Mask>
+		inline void _compact(Mask mask, std::true_type)
+		{
+			// Closes the gap left by the words compacted so far if mask throws.
+			struct close_gap
 			{
-				elem_check = (this->m_data[i] >= rhs.m_data[i]);
+				stack_vector& m_vector;
+				size_t m_kept;
+				size_t m_next;
+				inline ~close_gap()
+				{
+					const size_t rest = m_vector.m_size - m_next;
+					if (m_kept != m_next)
+						std::memmove(static_cast<void*>(m_vector._data() + m_kept), static_cast<const void*>(m_vector._data() + m_next), rest * sizeof(T));
+					m_vector.m_size = m_kept + rest;
+				}
+			} state{ *this, 0, 0 };
+
+			for (size_t word = 0; state.m_next < m_size; word++) {
+				const size_t base = state.m_next;
+				const size_t count = m_size - base < 64 ? m_size - base : 64;
+				const std::uint64_t all = count == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+				const std::uint64_t erase = mask(word) & all;
+
+				if (!std::is_trivially_destructible<T>::value) {
+					for (std::uint64_t bits = erase; bits != 0; bits &= bits - 1)
+						this->_destroy(&this->_data()[base + detail::countr_zero64(bits)]);
+				}
+
+				if (erase == 0) {
+					// A whole word kept, move it down in one go (or leave it where it is).
+					if (state.m_kept != base)
+						std::memmove(static_cast<void*>(this->_data() + state.m_kept), static_cast<const void*>(this->_data() + base), count * sizeof(T));
+					state.m_kept += count;
+				}
+				else {
+					// Copy every element and only advance past the kept ones, without branching.
+					for (size_t i = 0; i < count; i++) {
+						std::memmove(static_cast<void*>(this->_data() + state.m_kept), static_cast<const void*>(this->_data() + base + i), sizeof(T));
+						state.m_kept += 1 - static_cast<size_t>((erase >> i) & 1u);
+					}
+				}
+				state.m_next = base + count;
 			}
+		}
 
-			return (same_size && elem_check);
+		// Destroy everything from new_size on.
+		SAD_CONSTEXPR inline void _shrink_to(const size_t new_size) noexcept
+		{
+			for (size_t i = new_size; i < m_size; i++)
+				this->_destroy(&this->_data()[i]);
+			m_size = new_size;
 		}
 
+		// Move count elements from src to the raw memory at dst, destroying them at src.
+		SAD_CONSTEXPR inline void _relocate(T* dst, T* src, const size_t count)
+		{
+			this->_instrument_moved(count);
+			this->_relocate(dst, src, count, relocatable());
+		}
 
-		/* Helper Functions */
-	private:
+		SAD_CONSTEXPR inline void _relocate(T* dst, T* src, const size_t count, std::true_type) noexcept
+		{
+			if (SAD_IS_CONSTANT_EVALUATED())
+				return this->_relocate(dst, src, count, std::false_type());
+			if (count > 0)
+				std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+		}
 
-		// Reallocate stack memory to accomodate for new size.
-		inline void _reallocate(const size_t new_capacity)
+		SAD_CONSTEXPR inline void _relocate(T* dst, T* src, const size_t count, std::false_type)
 		{
+			for (size_t i = 0; i < count; i++) {
+				this->_construct(&dst[i], std::move(src[i]));
+				this->_destroy(&src[i]);
+			}
+		}
 
-			
+		// First element. Inline-only vectors work it out from their buffer instead of keeping a pointer
+		// into themselves, which a constexpr variable isn't allowed to hold.
+		SAD_CONSTEXPR inline T* _data() const noexcept { return this->_data(storage_category()); }
+		SAD_CONSTEXPR inline T* _data(detail::inline_only_tag) const noexcept { return const_cast<T*>(this->_inline_data()); }
+		SAD_CONSTEXPR inline T* _data(detail::allocator_tag) const noexcept { return m_data; }
 
-			#if _WIN32
-				T* new_data = static_cast<T*>(_alloca(new_capacity * sizeof(T)));
-			#elif defined(__linux__) // Or #if __linux__
-				T* new_data = static_cast<T*>(alloca(new_capacity * sizeof(T)));
-			#elif defined(__APPLE__) // Or #if MacOS
-				T* new_data = static_cast<T*>(alloca(new_capacity * sizeof(T)));
-			#endif
+		// Feed the inline bytes in use to the instrumentation, the vector's real share of its stack frame.
+		SAD_CONSTEXPR inline void _instrument_size() noexcept
+		{
+			this->_instrument_stack_bytes(this->is_inline() ? m_size * sizeof(T) : 0);
+		}
 
+		// Reallocate memory to accomodate for new size.
+		SAD_CONSTEXPR inline void _reallocate(const size_t new_capacity)
+		{
+			const T* old_data = this->_data();
+			const size_t old_capacity = m_capacity;
 
+			this->_reallocate(new_capacity, storage_category());
+			this->_instrument_reallocate(old_data, old_capacity, this->_data(), m_capacity);
+		}
+
+		// Inline storage never moves, only the bounds are checked.
+		SAD_CONSTEXPR inline void _reallocate(const size_t new_capacity, detail::inline_only_tag)
+		{
+			if (new_capacity > N)
+				detail::throw_length_error("sad::stack_vector: inline capacity exceeded");
+
+			for (size_t i = new_capacity; i < m_size; i++)
+				this->_destroy(&this->_data()[i]);
 			if (new_capacity < this->m_size)
 				this->m_size = new_capacity;
 
-			for (size_t i = 0; i < m_size; i++)
-				new (&new_data[i]) T(std::move(m_data[i]));
+			this->m_capacity = N;
+		}
 
-			for (size_t i = 0; i < m_size; i++) {
-				this->m_data[i].~T();
+		// Use the inline buffer while everything fits, otherwise a block from the allocator.
+		SAD_CONSTEXPR inline void _reallocate(const size_t new_capacity, detail::allocator_tag)
+		{
+			// Growing the most recent block of an arena is just a pointer bump, nothing moves.
+			if (new_capacity > m_capacity && this->_owns_allocation()
+				&& this->_try_extend(new_capacity, detail::has_try_extend<allocator_type, T>())) {
+				this->m_capacity = new_capacity;
+				return;
+			}
+
+			const bool fits_inline = new_capacity <= N;
+			T* new_data = fits_inline ? this->_inline_data() : allocator_traits::allocate(this->_allocator(), new_capacity);
+			const size_t capacity = fits_inline ? N : new_capacity;
+
+			for (size_t i = new_capacity; i < m_size; i++)
+				this->_destroy(&this->_data()[i]);
+			if (new_capacity < this->m_size)
+				this->m_size = new_capacity;
+
+			if (new_data != this->_data()) {
+				this->_relocate(new_data, this->_data(), m_size);
+				this->_release();
 			}
 
 			this->m_data = new_data;
-			this->m_capacity = new_capacity;
+			this->m_capacity = capacity;
+		}
+
+		// Check if m_data is a block that has to be handed back to the allocator.
+		SAD_CONSTEXPR inline bool _owns_allocation() const noexcept
+		{
+			return std::is_same<storage_category, detail::allocator_tag>::value && this->_data() != nullptr && this->_data() != this->_inline_data();
+		}
+
+		// Give the current block back to the allocator, if there is one.
+		SAD_CONSTEXPR inline void _release() noexcept
+		{
+			this->_release(storage_category());
+		}
+
+		SAD_CONSTEXPR inline void _release(detail::inline_only_tag) noexcept {}
+
+		SAD_CONSTEXPR inline void _release(detail::allocator_tag) noexcept
+		{
+			if (this->_owns_allocation())
+				allocator_traits::deallocate(this->_allocator(), this->_data(), this->m_capacity);
+		}
+
+		// Construct an element in place, through the allocator so it can customise it.
+		template<typename... Args>
+		SAD_CONSTEXPR inline void _construct(T* ptr, Args&&... args)
+		{
+			allocator_traits::construct(this->_allocator(), ptr, std::forward<Args>(args)...);
+		}
+
+		// Destroy an element in place, through the allocator.
+		SAD_CONSTEXPR inline void _destroy(T* ptr) noexcept
+		{
+			allocator_traits::destroy(this->_allocator(), ptr);
+		}
+
+		SAD_CONSTEXPR inline bool _try_extend(const size_t new_capacity, std::true_type) noexcept
+		{
+			return this->_allocator().try_extend(this->_data(), this->m_capacity, new_capacity);
+		}
+
+		SAD_CONSTEXPR inline bool _try_extend(const size_t, std::false_type) noexcept { return false; }
+
+		// Take the allocated block of other, which is left empty on its inline buffer.
+		SAD_CONSTEXPR inline void _steal(stack_vector& other) noexcept
+		{
+			this->m_data = other.m_data;
+			this->m_size = other.m_size;
+			this->m_capacity = other.m_capacity;
+
+			other.m_data = other._inline_data();
+			other.m_size = 0;
+			other.m_capacity = N;
+		}
+
+		// Allocated blocks trade places, anything on an inline buffer is moved across.
+		SAD_CONSTEXPR inline void _swap(stack_vector& other, detail::allocator_tag) noexcept
+		{
+			if (this->_owns_allocation() && other._owns_allocation()) {
+				std::swap(this->_allocator(), other._allocator());
+				std::swap(m_size, other.m_size);
+				std::swap(m_capacity, other.m_capacity);
+				std::swap(m_data, other.m_data);
+				return;
+			}
+
+			stack_vector temp(std::move(other));
+			other = std::move(*this);
+			*this = std::move(temp);
+		}
+
+		// Inline buffers are part of the objects, so the elements are exchanged instead.
+		SAD_CONSTEXPR inline void _swap(stack_vector& other, detail::inline_only_tag) noexcept
+		{
+			stack_vector& longer = (m_size >= other.m_size) ? *this : other;
+			stack_vector& shorter = (m_size >= other.m_size) ? other : *this;
+			const size_t common = shorter.m_size;
+
+			for (size_t i = 0; i < common; i++)
+				std::swap(this->_data()[i], other._data()[i]);
+
+			for (size_t i = common; i < longer.m_size; i++) {
+				shorter._construct(&shorter._data()[i], std::move(longer._data()[i]));
+				longer._destroy(&longer._data()[i]);
+			}
+			this->_instrument_moved(longer.m_size - common);
+			std::swap(m_size, other.m_size);
+			this->_instrument_size();
+			other._instrument_size();
 		}
 
 
 		/* Members */
 	protected:
-		T* m_data = nullptr; // Points to an array of values.
+		T* m_data = nullptr; // Points to an array of values, unused by inline-only vectors.
 		size_t m_size = 0; // Size of stack vector.
 		size_t m_capacity = 0; // Total memory allocated by m_data.
 
-	}; // !stack_vector<T> class
+	}; // !stack_vector<T, N, Allocator, Growth> class
+
+	template<typename T, std::size_t N, typename Allocator, typename Growth>
+	constexpr std::size_t stack_vector<T, N, Allocator, Growth>::inline_capacity;
+
+	// Erase every element of vec pred returns true for, like std::erase_if. Returns how many were erased.
+	template<typename T, std::size_t N, typename Allocator, typename Growth, typename Pred>
+	inline size_t erase_if(stack_vector<T, N, Allocator, Growth>& vec, Pred pred)
+	{
+		return vec.erase_if(pred);
+	}
+
+	// Erase every element of vec equal to value, like std::erase. Returns how many were erased.
+	template<typename T, std::size_t N, typename Allocator, typename Growth, typename U>
+	inline size_t erase(stack_vector<T, N, Allocator, Growth>& vec, const U& value)
+	{
+		return vec.erase_if([&value](const T& element) { return element == value; });
+	}
 
 } // !namespace sad
+
+// stack_vector<bool> packs its flags 64 to a word.
+#include "stack_vector_bool.hpp"
+
+// Returned by reserve_and_append_uninitialized.
+#include "span.hpp"
+
 #endif
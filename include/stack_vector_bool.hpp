@@ -0,0 +1,672 @@
+#ifndef STACK_VECTOR_BOOL_H
+#define STACK_VECTOR_BOOL_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "stack_vector.hpp"
+
+// Stack Allocated Data
+namespace sad {
+
+	namespace detail {
+
+		// Word storage behind stack_vector<bool>, with the same allocator as the bits.
+		template<typename Allocator, typename Word>
+		struct word_allocator_for { using type = typename std::allocator_traits<Allocator>::template rebind_alloc<Word>; };
+
+		template<typename Word>
+		struct word_allocator_for<void, Word> { using type = void; };
+
+	} // !namespace detail
+
+
+	// Bit-packed stack_vector<bool>, 64 flags per word. The words are kept in a
+	// stack_vector<std::uint64_t, (N + 63) / 64, Allocator, Growth>, so every storage mode of the
+	// primary template carries over (N is rounded up to a whole number of words).
+	// Whole-vector operations (flip, count, any/all/none, find_first, &, |, ^) work a word at a
+	// time, in plain loops the compiler can vectorize.
+	// Bits past size() in the last word are always kept at zero.
+	template<std::size_t N, typename Allocator, typename Growth>
+	class stack_vector<bool, N, Allocator, Growth>
+	{
+	public:
+		using ValueType = bool;
+		using word_type = std::uint64_t;
+		using allocator_type = typename detail::allocator_for<bool, Allocator>::type;
+		using growth_type = Growth;
+		using const_reference = bool;
+
+		static constexpr std::size_t bits_per_word = 64;
+
+		// Number of bits stored inside the object.
+		static constexpr std::size_t inline_capacity = ((N + bits_per_word - 1) / bits_per_word) * bits_per_word;
+
+		// Returned by find_first() and find_next() when no bit is set.
+		static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	private:
+		using word_vector = stack_vector<word_type, (N + bits_per_word - 1) / bits_per_word, typename detail::word_allocator_for<Allocator, word_type>::type, Growth>;
+
+	public:
+		// Proxy standing in for a bool& to a single bit.
+		class reference
+		{
+		public:
+			inline reference(word_type& word, word_type mask) noexcept : m_word(&word), m_mask(mask) {}
+
+			inline operator bool() const noexcept { return (*m_word & m_mask) != 0; }
+			inline bool operator~() const noexcept { return (*m_word & m_mask) == 0; }
+
+			inline reference& operator=(bool value) noexcept
+			{
+				if (value)
+					*m_word |= m_mask;
+				else
+					*m_word &= ~m_mask;
+				return *this;
+			}
+
+			inline reference& operator=(const reference& other) noexcept { return *this = static_cast<bool>(other); }
+
+			inline void flip() noexcept { *m_word ^= m_mask; }
+
+		private:
+			word_type* m_word; // Word holding the bit.
+			word_type m_mask; // The bit within the word.
+		};
+
+		class iterator;
+
+		class const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = bool;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = bool;
+
+		public:
+			inline const_iterator() noexcept : m_words(nullptr), m_index(0) {}
+			inline const_iterator(const word_type* words, size_t index) noexcept : m_words(words), m_index(index) {}
+
+			_NODISCARD inline bool operator*() const noexcept { return (m_words[m_index / bits_per_word] >> (m_index % bits_per_word)) & 1u; }
+			_NODISCARD inline bool operator[](const difference_type offset) const noexcept { return *(*this + offset); }
+
+			inline const_iterator& operator++() noexcept { ++m_index; return *this; }
+			inline const_iterator operator++(int) noexcept { const_iterator tmp = *this; ++m_index; return tmp; }
+			inline const_iterator& operator--() noexcept { --m_index; return *this; }
+			inline const_iterator operator--(int) noexcept { const_iterator tmp = *this; --m_index; return tmp; }
+
+			inline const_iterator& operator+=(const difference_type val) noexcept { m_index += val; return *this; }
+			inline const_iterator& operator-=(const difference_type val) noexcept { m_index -= val; return *this; }
+			_NODISCARD inline const_iterator operator+(const difference_type val) const noexcept { return const_iterator(m_words, m_index + val); }
+			_NODISCARD inline const_iterator operator-(const difference_type val) const noexcept { return const_iterator(m_words, m_index - val); }
+			_NODISCARD inline difference_type operator-(const const_iterator& other) const noexcept { return static_cast<difference_type>(m_index - other.m_index); }
+
+			_NODISCARD inline bool operator==(const const_iterator& other) const noexcept { return m_index == other.m_index; }
+			_NODISCARD inline bool operator!=(const const_iterator& other) const noexcept { return m_index != other.m_index; }
+			_NODISCARD inline bool operator<(const const_iterator& other) const noexcept { return m_index < other.m_index; }
+			_NODISCARD inline bool operator>(const const_iterator& other) const noexcept { return m_index > other.m_index; }
+			_NODISCARD inline bool operator<=(const const_iterator& other) const noexcept { return m_index <= other.m_index; }
+			_NODISCARD inline bool operator>=(const const_iterator& other) const noexcept { return m_index >= other.m_index; }
+
+		private:
+			friend class stack_vector;
+
+			const word_type* m_words; // Start of the word array.
+			size_t m_index; // Bit pointed at.
+		};
+
+		class iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = bool;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = typename stack_vector::reference;
+
+		public:
+			inline iterator() noexcept : m_words(nullptr), m_index(0) {}
+			inline iterator(word_type* words, size_t index) noexcept : m_words(words), m_index(index) {}
+
+			inline operator const_iterator() const noexcept { return const_iterator(m_words, m_index); }
+
+			_NODISCARD inline reference operator*() const noexcept { return reference(m_words[m_index / bits_per_word], word_type(1) << (m_index % bits_per_word)); }
+			_NODISCARD inline reference operator[](const difference_type offset) const noexcept { return *(*this + offset); }
+
+			inline iterator& operator++() noexcept { ++m_index; return *this; }
+			inline iterator operator++(int) noexcept { iterator tmp = *this; ++m_index; return tmp; }
+			inline iterator& operator--() noexcept { --m_index; return *this; }
+			inline iterator operator--(int) noexcept { iterator tmp = *this; --m_index; return tmp; }
+
+			inline iterator& operator+=(const difference_type val) noexcept { m_index += val; return *this; }
+			inline iterator& operator-=(const difference_type val) noexcept { m_index -= val; return *this; }
+			_NODISCARD inline iterator operator+(const difference_type val) const noexcept { return iterator(m_words, m_index + val); }
+			_NODISCARD inline iterator operator-(const difference_type val) const noexcept { return iterator(m_words, m_index - val); }
+			_NODISCARD inline difference_type operator-(const iterator& other) const noexcept { return static_cast<difference_type>(m_index - other.m_index); }
+
+			_NODISCARD inline bool operator==(const iterator& other) const noexcept { return m_index == other.m_index; }
+			_NODISCARD inline bool operator!=(const iterator& other) const noexcept { return m_index != other.m_index; }
+			_NODISCARD inline bool operator<(const iterator& other) const noexcept { return m_index < other.m_index; }
+			_NODISCARD inline bool operator>(const iterator& other) const noexcept { return m_index > other.m_index; }
+			_NODISCARD inline bool operator<=(const iterator& other) const noexcept { return m_index <= other.m_index; }
+			_NODISCARD inline bool operator>=(const iterator& other) const noexcept { return m_index >= other.m_index; }
+
+		private:
+			word_type* m_words; // Start of the word array.
+			size_t m_index; // Bit pointed at.
+		};
+
+		/* Allocation / Deallocation */
+	public:
+
+		// Default constructor.
+		inline stack_vector() = default;
+
+		// Construct with an allocator to spill into.
+		inline explicit stack_vector(const allocator_type& allocator) : m_words(typename word_vector::allocator_type(allocator)) {}
+
+		// Construct with a growth policy, e.g. a capacity_hint for growth::hinted.
+		inline explicit stack_vector(const growth_type& growth) : m_words(growth) {}
+
+		// Construct with an allocator to spill into and a growth policy.
+		inline stack_vector(const allocator_type& allocator, const growth_type& growth) : m_words(typename word_vector::allocator_type(allocator), growth) {}
+
+		// Fill constructor, reserves room for size bits.
+		inline explicit stack_vector(size_t size) : m_words(_words_for(size)) {}
+
+		inline stack_vector(std::initializer_list<bool> init_list)
+		{
+			this->assign(init_list);
+		}
+
+		/*----------------------------------------------------------*/
+		/*						  Modifiers						    */
+		/*----------------------------------------------------------*/
+
+		// Assign value of n amount
+		inline void assign(size_t n, bool value)
+		{
+			m_words.assign(_words_for(n), value ? ~word_type(0) : word_type(0));
+			m_size = n;
+			this->_clear_tail();
+		}
+
+		// Assign values by initializer list.
+		inline void assign(std::initializer_list<bool> init_list)
+		{
+			this->clear();
+			this->reserve(init_list.size());
+			for (bool value : init_list)
+				this->push_back(value);
+		}
+
+		inline void push_back(bool value)
+		{
+			if (m_size % bits_per_word == 0)
+				m_words.push_back(0);
+
+			if (value)
+				m_words[m_size / bits_per_word] |= _mask(m_size);
+			m_size++;
+		}
+
+		inline void emplace_back(bool value)
+		{
+			this->push_back(value);
+		}
+
+		inline void pop_back() noexcept
+		{
+			if (m_size > 0) {
+				m_size--;
+				m_words[m_size / bits_per_word] &= ~_mask(m_size);
+				if (m_size % bits_per_word == 0)
+					m_words.pop_back();
+			}
+		}
+
+		// Insert a bit at position, shifting the ones after it up a word at a time.
+		inline iterator insert(const_iterator position, bool value)
+		{
+			const size_t index = position.m_index;
+			assert(index <= m_size);
+
+			if (m_size % bits_per_word == 0)
+				m_words.push_back(0);
+			m_size++;
+
+			word_type* words = m_words.data();
+			const size_t first = index / bits_per_word;
+			for (size_t i = m_words.size() - 1; i > first; --i)
+				words[i] = (words[i] << 1) | (words[i - 1] >> (bits_per_word - 1));
+
+			const word_type below = _mask(index) - 1;
+			words[first] = (words[first] & below) | ((words[first] & ~below) << 1);
+
+			(*this)[index] = value;
+			return iterator(words, index);
+		}
+
+		inline iterator erase(const_iterator position) noexcept
+		{
+			assert(position.m_index < m_size);
+			this->_erase_bits(position.m_index, 1);
+			return iterator(m_words.data(), position.m_index);
+		}
+
+		inline iterator erase(const_iterator first, const_iterator last) noexcept
+		{
+			assert(first.m_index <= last.m_index && last.m_index <= m_size);
+			this->_erase_bits(first.m_index, last.m_index - first.m_index);
+			return iterator(m_words.data(), first.m_index);
+		}
+
+		inline void swap(stack_vector& other) noexcept
+		{
+			m_words.swap(other.m_words);
+			std::swap(m_size, other.m_size);
+		}
+
+		// Flip every bit.
+		inline void flip() noexcept
+		{
+			word_type* words = m_words.data();
+			for (size_t i = 0, n = m_words.size(); i < n; ++i)
+				words[i] = ~words[i];
+			this->_clear_tail();
+		}
+
+		// Set every bit.
+		inline void set() noexcept
+		{
+			std::fill(m_words.begin(), m_words.end(), ~word_type(0));
+			this->_clear_tail();
+		}
+
+		// Clear every bit, keeping the size.
+		inline void reset() noexcept
+		{
+			std::fill(m_words.begin(), m_words.end(), word_type(0));
+		}
+
+		/*----------------------------------------------------------*/
+		/*						Element access						*/
+		/*----------------------------------------------------------*/
+
+		// Get copy of bit at this index.
+		_NODISCARD inline bool at(const size_t index) const
+		{
+			assert(index < m_size);
+			return (*this)[index];
+		}
+
+		_NODISCARD inline reference front()
+		{
+			assert(m_size > 0);
+			return (*this)[0];
+		}
+
+		_NODISCARD inline bool front() const
+		{
+			assert(m_size > 0);
+			return (*this)[0];
+		}
+
+		_NODISCARD inline reference back()
+		{
+			assert(m_size > 0);
+			return (*this)[m_size - 1];
+		}
+
+		_NODISCARD inline bool back() const
+		{
+			assert(m_size > 0);
+			return (*this)[m_size - 1];
+		}
+
+		// Get the packed words, bit i being bit (i % 64) of word i / 64.
+		_NODISCARD inline word_type* word_data() noexcept { return m_words.data(); }
+		_NODISCARD inline const word_type* word_data() const noexcept { return m_words.data(); }
+
+		// Get amount of words in use.
+		_NODISCARD inline size_t word_count() const noexcept { return m_words.size(); }
+
+		/*----------------------------------------------------------*/
+		/*						 Bit queries						*/
+		/*----------------------------------------------------------*/
+
+		// Get amount of set bits.
+		_NODISCARD inline size_t count() const noexcept
+		{
+			const word_type* words = m_words.data();
+			size_t total = 0;
+			for (size_t i = 0, n = m_words.size(); i < n; ++i)
+				total += detail::popcount64(words[i]);
+			return total;
+		}
+
+		// Check if any bit is set.
+		_NODISCARD inline bool any() const noexcept
+		{
+			const word_type* words = m_words.data();
+			word_type combined = 0;
+			for (size_t i = 0, n = m_words.size(); i < n; ++i)
+				combined |= words[i];
+			return combined != 0;
+		}
+
+		// Check if no bit is set.
+		_NODISCARD inline bool none() const noexcept { return !this->any(); }
+
+		// Check if every bit is set, true when empty.
+		_NODISCARD inline bool all() const noexcept
+		{
+			const word_type* words = m_words.data();
+			const size_t full = m_size / bits_per_word;
+
+			word_type combined = ~word_type(0);
+			for (size_t i = 0; i < full; ++i)
+				combined &= words[i];
+
+			if (combined != ~word_type(0))
+				return false;
+			return m_size % bits_per_word == 0 || words[full] == _mask(m_size) - 1;
+		}
+
+		// Index of the first set bit, or npos.
+		_NODISCARD inline size_t find_first() const noexcept
+		{
+			return this->_find_from(0);
+		}
+
+		// Index of the first set bit after index, or npos.
+		_NODISCARD inline size_t find_next(const size_t index) const noexcept
+		{
+			return index + 1 >= m_size ? npos : this->_find_from(index + 1);
+		}
+
+		/*----------------------------------------------------------*/
+		/*						Iterators							*/
+		/*----------------------------------------------------------*/
+
+		_NODISCARD inline iterator begin() noexcept { return iterator(m_words.data(), 0); }
+		_NODISCARD inline iterator end() noexcept { return iterator(m_words.data(), m_size); }
+		_NODISCARD inline const_iterator begin() const noexcept { return const_iterator(m_words.data(), 0); }
+		_NODISCARD inline const_iterator end() const noexcept { return const_iterator(m_words.data(), m_size); }
+		_NODISCARD inline const_iterator cbegin() const noexcept { return const_iterator(m_words.data(), 0); }
+		_NODISCARD inline const_iterator cend() const noexcept { return const_iterator(m_words.data(), m_size); }
+
+		/*----------------------------------------------------------*/
+		/*						   Capacity						    */
+		/*----------------------------------------------------------*/
+
+		// Get amount of bits.
+		_NODISCARD inline size_t size() const noexcept { return m_size; }
+
+		_NODISCARD inline size_t max_size() const noexcept
+		{
+			const size_t words = m_words.max_size();
+			return words > std::numeric_limits<size_t>::max() / bits_per_word ? std::numeric_limits<size_t>::max() : words * bits_per_word;
+		}
+
+		// Get amount of bits that can fit.
+		_NODISCARD inline size_t capacity() const noexcept { return m_words.capacity() * bits_per_word; }
+
+		// Get a copy of the allocator used once the inline buffer is outgrown.
+		_NODISCARD inline allocator_type get_allocator() const noexcept { return allocator_type(m_words.get_allocator()); }
+
+		// Attach call site counters, see SAD_INSTRUMENT in instrumentation.hpp.
+		inline void instrument(instrumentation::stats& site) noexcept { m_words.instrument(site); }
+
+		// Check if the bits are in the inline buffer.
+		_NODISCARD inline bool is_inline() const noexcept { return m_words.is_inline(); }
+
+		// Check if the bits have moved out of the inline buffer, always true when N is 0.
+		_NODISCARD inline bool spilled() const noexcept { return m_words.spilled(); }
+
+		// Destroy vector contents
+		inline void clear() noexcept
+		{
+			m_words.clear();
+			m_size = 0;
+		}
+
+		// Change size, new bits are set to value.
+		inline void resize(size_t size, bool value = false)
+		{
+			const word_type fill = value ? ~word_type(0) : word_type(0);
+			if (value && size > m_size && m_size % bits_per_word != 0)
+				m_words[m_size / bits_per_word] |= ~(_mask(m_size) - 1);
+
+			m_words.resize(_words_for(size), fill);
+			m_size = size;
+			this->_clear_tail();
+		}
+
+		// Reserve room for new_capacity bits.
+		inline void reserve(size_t new_capacity)
+		{
+			m_words.reserve(_words_for(new_capacity));
+		}
+
+		// Check if empty
+		_NODISCARD inline bool empty() const noexcept { return m_size == 0; }
+
+		void shrink_to_fit() { m_words.shrink_to_fit(); }
+
+		/*----------------------------------------------------------*/
+		/*						Operator Overload					*/
+		/*----------------------------------------------------------*/
+	public:
+		void* operator new(size_t size); // Disable new
+		void operator delete(void*); // Disable delete
+
+		_NODISCARD inline reference operator[](const size_t index) noexcept
+		{
+			assert(index < m_size);
+			return reference(m_words[index / bits_per_word], _mask(index));
+		}
+
+		_NODISCARD inline bool operator[](const size_t index) const noexcept
+		{
+			assert(index < m_size);
+			return (m_words[index / bits_per_word] & _mask(index)) != 0;
+		}
+
+		/* Bitwise, both vectors must be the same size */
+		template<std::size_t M, typename A, typename G>
+		inline stack_vector& operator&=(const stack_vector<bool, M, A, G>& rhs) noexcept
+		{
+			assert(m_size == rhs.size());
+			word_type* words = m_words.data();
+			const word_type* other = rhs.word_data();
+			for (size_t i = 0, n = m_words.size(); i < n; ++i)
+				words[i] &= other[i];
+			return *this;
+		}
+
+		template<std::size_t M, typename A, typename G>
+		inline stack_vector& operator|=(const stack_vector<bool, M, A, G>& rhs) noexcept
+		{
+			assert(m_size == rhs.size());
+			word_type* words = m_words.data();
+			const word_type* other = rhs.word_data();
+			for (size_t i = 0, n = m_words.size(); i < n; ++i)
+				words[i] |= other[i];
+			return *this;
+		}
+
+		template<std::size_t M, typename A, typename G>
+		inline stack_vector& operator^=(const stack_vector<bool, M, A, G>& rhs) noexcept
+		{
+			assert(m_size == rhs.size());
+			word_type* words = m_words.data();
+			const word_type* other = rhs.word_data();
+			for (size_t i = 0, n = m_words.size(); i < n; ++i)
+				words[i] ^= other[i];
+			return *this;
+		}
+
+		// Copy with every bit flipped.
+		_NODISCARD inline stack_vector operator~() const
+		{
+			stack_vector result(*this);
+			result.flip();
+			return result;
+		}
+
+		/* Relational */
+		// Lexicographic three-way comparison (false before true), found from the lowest differing bit of each word pair.
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD inline int compare(const stack_vector<bool, M, A, G>& rhs) const noexcept
+		{
+			const size_t n = m_size < rhs.size() ? m_size : rhs.size();
+			const word_type* words = m_words.data();
+			const word_type* other = rhs.word_data();
+
+			for (size_t i = 0, count = _words_for(n); i < count; ++i) {
+				word_type diff = words[i] ^ other[i];
+				if (i == n / bits_per_word)
+					diff &= _mask(n) - 1; // Only the first n bits take part.
+
+				if (diff != 0)
+					return (words[i] >> detail::countr_zero64(diff)) & 1u ? 1 : -1;
+			}
+			return m_size < rhs.size() ? -1 : (m_size > rhs.size() ? 1 : 0);
+		}
+
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD inline bool operator==(const stack_vector<bool, M, A, G>& rhs) const noexcept
+		{
+			// Unused tail bits are zero on both sides, so whole words can be compared.
+			return m_size == rhs.size() && (m_size == 0 || std::memcmp(m_words.data(), rhs.word_data(), m_words.size() * sizeof(word_type)) == 0);
+		}
+
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD inline bool operator!=(const stack_vector<bool, M, A, G>& rhs) const noexcept
+		{
+			return !(*this == rhs);
+		}
+
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD inline bool operator<(const stack_vector<bool, M, A, G>& rhs) const noexcept { return this->compare(rhs) < 0; }
+
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD inline bool operator<=(const stack_vector<bool, M, A, G>& rhs) const noexcept { return this->compare(rhs) <= 0; }
+
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD inline bool operator>(const stack_vector<bool, M, A, G>& rhs) const noexcept { return this->compare(rhs) > 0; }
+
+		template<std::size_t M, typename A, typename G>
+		_NODISCARD inline bool operator>=(const stack_vector<bool, M, A, G>& rhs) const noexcept { return this->compare(rhs) >= 0; }
+
+		/* Helper Functions */
+	private:
+		static inline size_t _words_for(const size_t bits) noexcept { return (bits + bits_per_word - 1) / bits_per_word; }
+		static inline word_type _mask(const size_t index) noexcept { return word_type(1) << (index % bits_per_word); }
+
+		// Zero the bits past size() in the last word.
+		inline void _clear_tail() noexcept
+		{
+			if (m_size % bits_per_word != 0)
+				m_words[m_size / bits_per_word] &= _mask(m_size) - 1;
+		}
+
+		// 64 bits starting at bit index, reading zeros past the last word.
+		inline word_type _bits_at(const size_t index) const noexcept
+		{
+			const size_t word = index / bits_per_word;
+			const size_t shift = index % bits_per_word;
+
+			word_type bits = m_words[word] >> shift;
+			if (shift != 0 && word + 1 < m_words.size())
+				bits |= m_words[word + 1] << (bits_per_word - shift);
+			return bits;
+		}
+
+		// Remove count bits at index, moving the rest down a word at a time.
+		inline void _erase_bits(const size_t index, const size_t count) noexcept
+		{
+			if (count == 0)
+				return;
+
+			word_type* words = m_words.data();
+			size_t dst = index;
+			for (size_t src = index + count; src < m_size;) {
+				const size_t shift = dst % bits_per_word;
+				const word_type below = _mask(dst) - 1;
+
+				words[dst / bits_per_word] = (words[dst / bits_per_word] & below) | (this->_bits_at(src) << shift);
+				dst += bits_per_word - shift;
+				src += bits_per_word - shift;
+			}
+
+			m_size -= count;
+			m_words.resize(_words_for(m_size));
+			this->_clear_tail();
+		}
+
+		inline size_t _find_from(const size_t index) const noexcept
+		{
+			const word_type* words = m_words.data();
+			size_t word = index / bits_per_word;
+			if (word >= m_words.size())
+				return npos;
+
+			// Ignore the bits before index in the first word.
+			word_type bits = words[word] & ~(_mask(index) - 1);
+			while (bits == 0) {
+				if (++word == m_words.size())
+					return npos;
+				bits = words[word];
+			}
+			return word * bits_per_word + detail::countr_zero64(bits);
+		}
+
+		/* Members */
+	private:
+		word_vector m_words; // Packed bits.
+		size_t m_size = 0; // Amount of bits.
+
+	}; // !stack_vector<bool, N, Allocator, Growth> class
+
+	template<std::size_t N, typename Allocator, typename Growth>
+	constexpr std::size_t stack_vector<bool, N, Allocator, Growth>::bits_per_word;
+
+	template<std::size_t N, typename Allocator, typename Growth>
+	constexpr std::size_t stack_vector<bool, N, Allocator, Growth>::inline_capacity;
+
+	template<std::size_t N, typename Allocator, typename Growth>
+	constexpr std::size_t stack_vector<bool, N, Allocator, Growth>::npos;
+
+	/* Bitwise, both vectors must be the same size */
+	template<std::size_t N, typename Allocator, typename Growth, std::size_t M, typename A, typename G>
+	_NODISCARD inline stack_vector<bool, N, Allocator, Growth> operator&(const stack_vector<bool, N, Allocator, Growth>& lhs, const stack_vector<bool, M, A, G>& rhs)
+	{
+		stack_vector<bool, N, Allocator, Growth> result(lhs);
+		result &= rhs;
+		return result;
+	}
+
+	template<std::size_t N, typename Allocator, typename Growth, std::size_t M, typename A, typename G>
+	_NODISCARD inline stack_vector<bool, N, Allocator, Growth> operator|(const stack_vector<bool, N, Allocator, Growth>& lhs, const stack_vector<bool, M, A, G>& rhs)
+	{
+		stack_vector<bool, N, Allocator, Growth> result(lhs);
+		result |= rhs;
+		return result;
+	}
+
+	template<std::size_t N, typename Allocator, typename Growth, std::size_t M, typename A, typename G>
+	_NODISCARD inline stack_vector<bool, N, Allocator, Growth> operator^(const stack_vector<bool, N, Allocator, Growth>& lhs, const stack_vector<bool, M, A, G>& rhs)
+	{
+		stack_vector<bool, N, Allocator, Growth> result(lhs);
+		result ^= rhs;
+		return result;
+	}
+
+} // !namespace sad
+#endif